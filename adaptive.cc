@@ -5,56 +5,229 @@
  * @brief SIMD dynamic banded
  */
 #include <string.h>
+#include "isa.h"
 #include "sse.h"
+#include "seq.h"
 #include "util.h"
 
 #define MIN 	( 0 )
 #define OFS 	( 32768 )
 
 /**
- * @fn adaptive_affine
+ * termination policies
+ *
+ * XDROP_CENTER: the center cell falls xt below the max of the center lane (original)
+ * XDROP_BAND:   all the cells of the vector fall xt below the max so far
+ * ZDROP:        BWA-MEM Z-drop; the best cell of the vector falls below the max
+ *               by more than xt plus |ge| times the diagonal distance between them
  */
-int
-adaptive_affine(
-	void *work,
-	char const *a,
-	uint64_t alen,
-	char const *b,
-	uint64_t blen,
-	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
-{
-	if(alen == 0 || blen == 0) { return(0); }
-	debug("%s, %s", a, b);
+enum { XDROP_CENTER = 0, XDROP_BAND = 1, ZDROP = 2 };
 
-	uint16_t *ptr = (uint16_t *)work;
+/**
+ * band advancing: a switch over the four (previous, current) direction pairs,
+ * or one code path blending the right and down shifts with the direction masks
+ */
+enum { DIR_BRANCH = 0, DIR_BLEND = 1 };
 
-	/* extract max and min */
-	int8_t sc_max = extract_max_score(score_matrix);
-	int8_t sc_min = extract_min_score(score_matrix);
-	/* fix gap open penalty */
-	gi += ge;
+/**
+ * steering policies, deciding the direction of the next vector
+ *
+ * STEER_EDGE:    the two edge cells of cv are compared (original)
+ * STEER_EDGEMAX: the max of the STEER_LANES outermost cells on each side
+ * STEER_GAP:     the edge cells with the gap running outward on each side
+ *                (f on the upper (b) edge, e on the lower (a) edge) counted in
+ * STEER_ARGMAX:  moves the lane of the max of cv toward the center, the edge
+ *                test breaks the tie
+ * STEER_HYST:    keeps the direction until the other edge leads by -gi
+ */
+enum { STEER_EDGE = 0, STEER_EDGEMAX = 1, STEER_GAP = 2, STEER_ARGMAX = 3, STEER_HYST = 4 };
+#define STEER_LANES		( 4 )
 
-	uint64_t const L = vec::LEN;
-	struct _w {
-		int8_t b[vec::LEN];
-		int8_t a[vec::LEN];
-		uint16_t pv[vec::LEN];
-		uint16_t cv[vec::LEN];
-		uint16_t ce[vec::LEN];
-		uint16_t cf[vec::LEN];
-		uint16_t max[vec::LEN];
-	} w[bw / L + 1] __attribute__(( aligned(16) ));
+/**
+ * band width: fixed, or widened by a vector when the band is starving, that is,
+ * the vector max stays xt / WIDEN_DROP below the max so far for WIDEN_STEPS
+ * vectors (the path runs into a gap and its other end is out of the band). It
+ * grows up to WIDEN_MAX times the initial width, half on each side as the
+ * steering would move a band widened on one side back to the max anyway, and
+ * is narrowed back after NARROW_STEPS vectors without pressure. The edge cells
+ * themselves are a poor signal: they stay within xt / 2 of the max on most
+ * pairs at small X, which kept the band at the widest.
+ */
+enum { BAND_STATIC = 0, BAND_DYNAMIC = 1 };
+#define WIDEN_DROP		( 16 )
+#define WIDEN_STEPS		( 2 )
+#define NARROW_STEPS	( 64 )
+#define WIDEN_MAX		( 4 )
+
+/**
+ * band-loss signals, reported by adaptive_affine_intl when asked for:
+ * LOSS_EDGE:   the STEER_LANES outermost lanes of either edge came within
+ *              bw / 4 gap extensions of the max so far, that is, a path ran
+ *              along or ended near the edge
+ * LOSS_RISING: X-drop terminated while an edge cell was still at the max of
+ *              its lane and within xt of the max so far
+ * the fallback chain reruns the pair with the next stage while any is set
+ */
+enum { LOSS_EDGE = 0x01, LOSS_RISING = 0x02 };
+#define CHAIN_WIDEN			( 4 )			/* bw of the second stage, multiplied */
+#define CHAIN_EXACT_CELLS	( 256 * 256 )	/* pairs up to this size go to the full dp */
+
+/**
+ * rebasing: the band max is brought back to OFS once it exceeds REBASE_THRESH,
+ * the difference moved to a 64-bit base. It is tested every REBASE_SPAN / sc_max
+ * vectors, so that the cells never pass 0xffff in between.
+ */
+#define REBASE_THRESH	( OFS + 16384 )
+#define REBASE_SPAN		( 8192 )
+
+/**
+ * short-read fast path: adaptive_affine runs the kernel at the compile-time width
+ * SHORT_BW when given it, with the initial band state copied in from a per-thread
+ * image built once per scoring. the AVX-512 build runs it on the 16-lane AVX2
+ * vector, its own being wider than the band.
+ */
+#define SHORT_BW		( 16 )
+#if defined(__AVX512BW__)
+typedef avx2_t short_isa_t;
+#else
+typedef isa_t short_isa_t;
+#endif
+
+/**
+ * streaming: adaptive_stream_affine (the bench) feeds b in chunks of STREAM_CHUNK
+ * bases, about 0.15 s of a nanopore pore at 450 bases per second
+ */
+#define STREAM_CHUNK	( 64 )
 
+/**
+ * band state layout:
+ * LAYOUT_AOS:    blocks of L lanes, each holding b, a, pv, cv, ce, cf, and max in a row
+ * LAYOUT_SOA:    a plane per field over all the blocks
+ * LAYOUT_HYBRID: the chars (b, a) in blocks of their own, apart from the score blocks
+ */
+enum { LAYOUT_AOS = 0, LAYOUT_SOA = 1, LAYOUT_HYBRID = 2 };
+
+/**
+ * path counters, carried through the band with the cells when asked for:
+ * COUNT_NONE: the scores alone
+ * COUNT_PATH: mismatches, gap bases, and gap opens on the path to each cell of
+ *             pv, cv, ce, and cf, taken from the neighbor its score came from.
+ *             They count errors only, so that they stay small in 16 bits; the
+ *             matches and the aligned columns at the max follow from its
+ *             i + j = 2 * (diagonal moves) + (gap bases).
+ */
+enum { COUNT_NONE = 0, COUNT_PATH = 1 };
+#define COUNT_FIELDS	( 3 )
+
+/**
+ * @struct band_s
+ *
+ * @brief the band state of cnt blocks over the work arena; band[i] gives the
+ * field pointers of block i, all vector-aligned for the work aligned to the cache line.
+ * The second gap pair (ce2, cf2) has its own fields only for GAP_DUAL, aliasing
+ * ce and cf otherwise; the counters of COUNT_PATH (pk, ck, ek, fk, of pv, cv, ce,
+ * and cf) follow the score fields.
+ */
+template<uint64_t L, int Y, int M = GAP_AFFINE, int K = COUNT_NONE>
+struct band_s {
+	struct block_s {
+		int8_t *b, *a;
+		uint16_t *pv, *cv, *ce, *cf, *max, *ce2, *cf2;
+		uint16_t *kb;							/* the first counter field, ks apart */
+		uint64_t ks;
+		inline uint16_t *pk(uint64_t k) const { return(kb + k * ks); }
+		inline uint16_t *ck(uint64_t k) const { return(kb + (COUNT_FIELDS + k) * ks); }
+		inline uint16_t *ek(uint64_t k) const { return(kb + (2 * COUNT_FIELDS + k) * ks); }
+		inline uint16_t *fk(uint64_t k) const { return(kb + (3 * COUNT_FIELDS + k) * ks); }
+	};
+	static uint64_t const LEN = L;
+	static int const GAP = M;
+	static int const CNT = K;
+	static uint64_t const S = M == GAP_DUAL ? 7 : 5;		/* score fields */
+	static uint64_t const F = S + (K == COUNT_PATH ? 4 * COUNT_FIELDS : 0);
+	uint8_t *base;
+	uint64_t cnt;
+
+	band_s(void *work, uint64_t cnt) : base((uint8_t *)work), cnt(cnt) {}
+
+	/* bytes of the band state, the planes starting on a cache line */
+	static size_t size(uint64_t cnt) {
+		switch(Y) {
+			case LAYOUT_SOA: return(2 * arena_roundup(L * cnt) + F * arena_roundup(2 * L * cnt));
+			case LAYOUT_HYBRID: return(arena_roundup(2 * L * cnt) + arena_roundup(2 * F * L * cnt));
+			default: return(arena_roundup((2 + 2 * F) * L * cnt));
+		}
+	}
+
+	inline block_s operator[](uint64_t i) const {
+		uint8_t *p, *q, *c;						/* b, the first score field, a */
+		uint64_t s;								/* stride between the score fields */
+		switch(Y) {
+			case LAYOUT_SOA: {
+				uint64_t const t = arena_roundup(L * cnt);
+				p = base + L * i; c = p + t;
+				q = base + 2 * t + 2 * L * i; s = arena_roundup(2 * L * cnt);
+			} break;
+			case LAYOUT_HYBRID: {
+				p = base + 2 * L * i; c = p + L;
+				q = base + arena_roundup(2 * L * cnt) + 2 * F * L * i; s = 2 * L;
+			} break;
+			default: {
+				p = base + (2 + 2 * F) * L * i; c = p + L;
+				q = p + 2 * L; s = 2 * L;
+			} break;
+		}
+		uint64_t const e2 = M == GAP_DUAL ? 5 : 2, f2 = M == GAP_DUAL ? 6 : 3;
+		block_s const r = { (int8_t *)p, (int8_t *)c,
+			(uint16_t *)q, (uint16_t *)(q + s), (uint16_t *)(q + 2 * s), (uint16_t *)(q + 3 * s), (uint16_t *)(q + 4 * s),
+			(uint16_t *)(q + e2 * s), (uint16_t *)(q + f2 * s), (uint16_t *)(q + S * s), s / 2 };
+		return(r);
+	}
+};
+
+/**
+ * @fn band_pad
+ *
+ * @brief the pad block j after the last lane, read as the edge of the next vector
+ */
+template<typename W>
+static inline
+void band_pad(W const &w, uint64_t j, int8_t gi, int8_t ge, int8_t sc_min, int8_t ge2 = 0)
+{
+	for(uint64_t i = 0; i < W::LEN; i++) {
+		w[j].b[i] = 0;
+		w[j].a[i] = 0;
+		w[j].pv[i] = -sc_min;
+		w[j].cv[i] = -gi;
+		w[j].ce[i] = -ge;
+		w[j].cf[i] = -ge;
+		w[j].max[i] = 0;
+		if(W::GAP == GAP_DUAL) { w[j].ce2[i] = w[j].cf2[i] = -ge2; }
+		for(uint64_t k = 0; k < (W::CNT == COUNT_PATH ? COUNT_FIELDS : 0); k++) {
+			w[j].pk(k)[i] = w[j].ck(k)[i] = w[j].ek(k)[i] = w[j].fk(k)[i] = 0;
+		}
+	}
+}
+
+/**
+ * @fn band_init
+ *
+ * @brief sets the sequence-independent part of the initial band state: the char
+ * pads, the gap-decreasing cells, the max, and the pad block after the bw lanes
+ * (gi is the one fixed with ge)
+ */
+template<typename T, typename W>
+static inline
+void band_init(W const &w, uint32_t bw, int8_t gi, int8_t ge, int8_t sc_max, int8_t sc_min, int8_t ge2 = 0)
+{
+	typedef vec_t<T> vec;
+	uint64_t const L = vec::LEN;
 
 	/* init char vec */
 	for(uint64_t i = 0; i < (uint64_t)bw / 2; i++) {
 		w[(bw / 2 + i) / L].a[(bw / 2 + i) % L] = 0x80;
 		w[i / L].b[i % L] = 0xff;
 	}
-	for(uint64_t i = 0; i < (uint64_t)bw / 2; i++) {
-		w[(bw / 2 - i - 1) / L].a[(bw / 2 - i - 1) % L] = encode_a(a[i]);
-		w[(bw / 2 + i) / L].b[(bw / 2 + i) % L] = encode_b(b[i]);
-	}
 
 	/* init vec */
 	#define _Q(x)		( (int64_t)(x) - (int64_t)bw / 2 )
@@ -67,22 +240,429 @@ adaptive_affine(
 	}
 	#undef _Q
 
-	/* init pad */
-	for(uint64_t i = 0; i < L; i++) {
-		w[bw / L].b[i] = 0;
-		w[bw / L].a[i] = 0;
-		w[bw / L].pv[i] = -sc_min;
-		w[bw / L].cv[i] = -gi;
-		w[bw / L].ce[i] = -ge;
-		w[bw / L].cf[i] = -ge;
-		w[bw / L].max[i] = 0;
+	/* the second gap pair starts closed; taken over by the first on the init cells */
+	if(W::GAP == GAP_DUAL) {
+		for(uint64_t i = 0; i < bw; i++) { w[i / L].ce2[i % L] = w[i / L].cf2[i % L] = MIN; }
+	}
+
+	/* the counters: (0, 0) on pv, a gap of one base on the others ((0, 1) and (1, 0) on cv) */
+	if(W::CNT == COUNT_PATH) {
+		for(uint64_t i = 0; i < bw; i++) {
+			w[i / L].pk(0)[i % L] = w[i / L].pk(1)[i % L] = w[i / L].pk(2)[i % L] = 0;
+			w[i / L].ck(0)[i % L] = w[i / L].ek(0)[i % L] = w[i / L].fk(0)[i % L] = 0;
+			w[i / L].ck(1)[i % L] = w[i / L].ek(1)[i % L] = w[i / L].fk(1)[i % L] = 1;
+			w[i / L].ck(2)[i % L] = w[i / L].ek(2)[i % L] = w[i / L].fk(2)[i % L] = 1;
+		}
 	}
 
+	/* init pad */
+	band_pad(w, bw / L, gi, ge, sc_min, ge2);
+
 	/* init maxv */
 	for(uint64_t i = 0; i < (uint64_t)bw / L; i++) {
 		vec t(w[i].pv);
 		t.store(w[i].max);
 	}
+}
+
+/**
+ * @fn band_copy
+ *
+ * @brief copies cnt blocks of the band state, a vector per field
+ */
+template<typename T, typename W, typename V>
+static inline
+void band_copy(W const &w, V const &v, uint64_t cnt)
+{
+	typedef vec_t<T> vec;
+	typedef char_vec_t<T> char_vec;
+
+	for(uint64_t i = 0; i < cnt; i++) {
+		char_vec tb(v[i].b), ta(v[i].a);
+		tb.store(w[i].b); ta.store(w[i].a);
+		vec tp(v[i].pv), tv(v[i].cv), te(v[i].ce), tf(v[i].cf), tm(v[i].max);
+		tp.store(w[i].pv); tv.store(w[i].cv);
+		te.store(w[i].ce); tf.store(w[i].cf);
+		tm.store(w[i].max);
+	}
+}
+
+/**
+ * @fn band_max
+ *
+ * @brief the max over the max field of the bw lanes
+ */
+template<typename T, typename W>
+static inline
+uint64_t band_max(W const &w, uint32_t bw)
+{
+	typedef vec_t<T> vec;
+
+	vec mv((uint16_t)MIN);
+	for(uint64_t i = 0; i < (uint64_t)(bw / W::LEN); i++) {
+		vec t(w[i].max);
+		mv = vec::max(mv, t);
+	}
+	return(mv.hmax());
+}
+
+/**
+ * @fn band_save, band_load
+ *
+ * @brief the bw lanes to and from the lane-ordered fields of stream_t (util.h), a
+ * block of L lanes per copy; the pad block is rebuilt on load
+ */
+template<typename W>
+static inline
+void band_save(uint8_t *q, W const &w, uint32_t bw)
+{
+	uint64_t const L = W::LEN;
+	uint16_t *s = (uint16_t *)(q + 2 * bw);
+	for(uint64_t i = 0; i < bw / L; i++) {
+		memcpy(&q[L * i], w[i].b, L); memcpy(&q[bw + L * i], w[i].a, L);
+		memcpy(&s[L * i], w[i].pv, 2 * L); memcpy(&s[bw + L * i], w[i].cv, 2 * L);
+		memcpy(&s[2 * bw + L * i], w[i].ce, 2 * L); memcpy(&s[3 * bw + L * i], w[i].cf, 2 * L);
+		memcpy(&s[4 * bw + L * i], w[i].max, 2 * L);
+	}
+}
+
+template<typename W>
+static inline
+void band_load(W const &w, uint8_t const *q, uint32_t bw, int8_t gi, int8_t ge, int8_t sc_min)
+{
+	uint64_t const L = W::LEN;
+	uint16_t const *s = (uint16_t const *)(q + 2 * bw);
+	for(uint64_t i = 0; i < bw / L; i++) {
+		memcpy(w[i].b, &q[L * i], L); memcpy(w[i].a, &q[bw + L * i], L);
+		memcpy(w[i].pv, &s[L * i], 2 * L); memcpy(w[i].cv, &s[bw + L * i], 2 * L);
+		memcpy(w[i].ce, &s[2 * bw + L * i], 2 * L); memcpy(w[i].cf, &s[3 * bw + L * i], 2 * L);
+		memcpy(w[i].max, &s[4 * bw + L * i], 2 * L);
+	}
+	band_pad(w, bw / L, gi, ge, sc_min);
+}
+
+/**
+ * @struct score_s
+ *
+ * @brief the score vector of a block of lanes: the 16-entry shuffle on the 2-bit
+ * codes (va | vb), a shuffle per quality bin on the qv view, or, on the protein
+ * view, a gather from the table of aa_matrix_t (a lane pairs its own residues of
+ * a and b on the anti-diagonal, for which no query profile applies)
+ */
+template<typename T, typename A>
+struct score_s {
+	vec_t<T> smv;
+	int8_t max, min;
+
+	score_s(A const &a, int8_t *score_matrix) : max(extract_max_score(score_matrix)), min(extract_min_score(score_matrix)) {
+		smv.load_table(score_matrix);
+	}
+	inline vec_t<T> operator()(char_vec_t<T> const &va, char_vec_t<T> const &vb) const {
+		return(smv.shuffle(va | vb));
+	}
+};
+
+template<typename T>
+struct score_s<T, qv_view> {
+	vec_t<T> smv[QV_BINS_MAX];
+	uint64_t nbin;
+	int8_t max, min;
+
+	score_s(qv_view const &a, int8_t *score_matrix) : nbin(a.m->nbin), max(a.m->max), min(a.m->min) {
+		for(uint64_t k = 0; k < nbin; k++) { smv[k].load_table(a.m->score[k]); }
+	}
+	/* bin k: the lanes of the other bins get the msb set (bits 4 to 6 left nonzero by the
+	   xor, saturated past 0x7f), so that the shuffle gives them zero */
+	inline vec_t<T> operator()(char_vec_t<T> const &va, char_vec_t<T> const &vb) const {
+		char_vec_t<T> const i = va | vb, c((int8_t)0x70);
+		vec_t<T> s = smv[0].shuffle(i.adds(c));
+		for(uint64_t k = 1; k < nbin; k++) {
+			s |= smv[k].shuffle((i ^ char_vec_t<T>((int8_t)(k<<4))).adds(c));
+		}
+		return(s);
+	}
+};
+
+template<typename T>
+struct score_s<T, aa_view> {
+	int8_t const *t;
+	int8_t max, min;
+
+	score_s(aa_view const &a, int8_t *score_matrix) : t(a.m->score), max(a.m->max), min(a.m->min) {}
+	inline vec_t<T> operator()(char_vec_t<T> const &va, char_vec_t<T> const &vb) const {
+		return(vec_t<T>::gather(t, va, vb));
+	}
+};
+
+/**
+ * @struct count_s
+ *
+ * @brief COUNT_PATH: where the cells of a block came from, in the order the traceback
+ * of full.c takes them (f, the gap along b, then e, then the diagonal; the extension
+ * before the open), and the mismatches on the diagonal
+ */
+template<typename T>
+struct count_s {
+	vec_t<T> mm, xe, xf, he, hf;
+
+	count_s(vec_t<T> const &mtv, char_vec_t<T> const &va, char_vec_t<T> const &vb, vec_t<T> const &gev,
+		vec_t<T> const &ve, vec_t<T> const &vf, vec_t<T> const &ne, vec_t<T> const &nf, vec_t<T> const &nv) :
+		mm(vec_t<T>((uint16_t)1) + mtv.shuffle(va | vb)),
+		xe(vec_t<T>::comp(ne, ve - gev)), xf(vec_t<T>::comp(nf, vf - gev)),
+		he(vec_t<T>::comp(nv, ne)), hf(vec_t<T>::comp(nv, nf)) {}
+
+	/* counter k of block i from the ones of the neighbors (d: the diagonal, h and v: the cells
+	   opening e and f, e and f: the gaps extended), c: its own before update, to pv */
+	template<typename W>
+	inline void update(W const &w, uint64_t i, uint64_t k, vec_t<T> const &c, vec_t<T> const &d,
+		vec_t<T> const &h, vec_t<T> const &v, vec_t<T> const &e, vec_t<T> const &f) const {
+		vec_t<T> const one((uint16_t)1);
+		vec_t<T> const qd = k == 0 ? d + mm : d;		/* mismatches, gap bases, gap opens */
+		vec_t<T> const qe = k == 1 ? xe.select(e, h) + one : xe.select(e, k == 2 ? h + one : h);
+		vec_t<T> const qf = k == 1 ? xf.select(f, v) + one : xf.select(f, k == 2 ? v + one : v);
+		c.store(w[i].pk(k)); qe.store(w[i].ek(k)); qf.store(w[i].fk(k));
+		hf.select(qf, he.select(qe, qd)).store(w[i].ck(k));
+	}
+};
+
+/**
+ * @fn find_lane
+ *
+ * @brief index of the first cell equal to s in the stored vector p (bw cells)
+ */
+template<typename T>
+static inline
+uint64_t find_lane(uint16_t const *p, uint16_t s, uint32_t bw)
+{
+	typedef vec_t<T> vec;
+
+	vec const t(s);
+	for(uint64_t i = 0; i < bw; i += vec::LEN) {
+		vec v; v.loadu(&p[i]);
+		uint64_t m = (v == t);
+		if(m != 0) { return(i + tzcnt(m) / 2); }
+	}
+	return(bw / 2);
+}
+
+/**
+ * @fn steer
+ *
+ * @brief returns 1 to go down (advance b), 0 to go right (advance a); w is the
+ * working vector array of adaptive_affine_intl, lane bw - 1 being the upper (b) edge
+ */
+template<typename T, int S, typename W>
+static inline
+uint64_t steer(W const &w, uint32_t bw, uint64_t dir, int8_t gi, int8_t ge)
+{
+	typedef vec_t<T> vec;
+	uint64_t const L = vec::LEN;
+	#define _cell(_x, _i)		( (int32_t)w[(_i) / L]._x[(_i) % L] )
+
+	int32_t up = _cell(cv, bw - 1), lo = _cell(cv, 0);
+	switch(S) {
+		case STEER_EDGEMAX: {
+			for(uint64_t i = 1; i < STEER_LANES; i++) {
+				up = MAX2(up, _cell(cv, bw - 1 - i));
+				lo = MAX2(lo, _cell(cv, i));
+			}
+		} break;
+		case STEER_GAP: {
+			/* scores of the next cells outside the band, open vs. extend */
+			up = MAX2(up + gi, _cell(cf, bw - 1) + ge);
+			lo = MAX2(lo + gi, _cell(ce, 0) + ge);
+		} break;
+		case STEER_ARGMAX: {
+			vec m((uint16_t)MIN);
+			for(uint64_t i = 0; i < bw / L; i++) { m = vec::max(m, vec(w[i].cv)); }
+			vec const t(m.hmax());
+			for(uint64_t i = 0; i < bw / L; i++) {
+				uint64_t k = (vec(w[i].cv) == t);
+				if(k == 0) { continue; }
+
+				uint64_t l = i * L + tzcnt(k) / 2;
+				if(l > bw / 2) { return(1); }
+				if(l + 1 < bw / 2) { return(0); }
+				break;
+			}
+		} break;
+		case STEER_HYST: {
+			/* the previous direction is in the lsb of dir */
+			return((dir & 0x01) ? lo <= up - gi : up > lo - gi);
+		} break;
+	}
+	return(up > lo);
+
+	#undef _cell
+}
+
+/**
+ * @struct glog_s
+ *
+ * @brief per anti-diagonal record of ALIGN_GLOBAL: apos after the step, and the
+ * base of its stored vector (the stored vectors are not rebased)
+ */
+struct glog_s {
+	uint32_t apos;
+	int32_t rbase;
+};
+
+/**
+ * @fn trace_global
+ *
+ * @brief the path from (alen, blen) back to (0, 0) on the stored vectors, in the
+ * letters of full.c (M, X, I, D), '\0'-terminated. Gotoh's e and f are the best of
+ * the cells a gap away on the same row or column, so the cells alone suffice.
+ * gi is the one fixed with ge. Returns -1, with the path left empty, if a cell has
+ * no predecessor (the stored vectors do not hold its path).
+ */
+template<typename A, typename B>
+static inline
+int trace_global(char *path, uint16_t const *st, glog_s const *log, uint32_t bw, A const &a, B const &b, int8_t const *score_matrix, int8_t gi, int8_t ge)
+{
+	int64_t const NEG = INT32_MIN;
+	/* (i, j) on a stored lane; the boundary cells by the init of full.c, the rest from the anti-diagonal i + j - 2 */
+	#define _in(_i, _j)	( log[(_i) + (_j) - 2].apos - (_i) < bw )
+	#define _h(_i, _j)	( (_i) == 0 || (_j) == 0 \
+		? ((_i) + (_j) == 0 ? 0 : gi + (int64_t)((_i) + (_j) - 1) * ge) \
+		: (_in(_i, _j) \
+			? (int64_t)st[((_i) + (_j) - 2) * bw + log[(_i) + (_j) - 2].apos - (_i)] - OFS + log[(_i) + (_j) - 2].rbase \
+			: NEG) )
+
+	uint64_t i = a.len, j = b.len, k = i + j;
+	path[k] = '\0';
+	while(i > 0 && j > 0) {
+		int64_t const h = _h(i, j);
+		if(h == _h(i - 1, j - 1) + score_matrix[a.encode_a(i - 1) | b.encode_b(j - 1)]) {
+			path[--k] = a.encode_a(i - 1) == (b.encode_b(j - 1)>>2) ? 'M' : 'X';
+			i--; j--; continue;
+		}
+		/* a gap of q, up to the boundary at zero or the end of the stored lanes; the band moves one
+		   way, so a cell off the lanes has none behind it on the same row or column */
+		uint64_t q;
+		for(q = 1; q <= j && (q == j || _in(i, j - q)); q++) {
+			if(_h(i, j - q) + gi + (int64_t)(q - 1) * ge == h) { break; }
+		}
+		if(q <= j && (q == j || _in(i, j - q))) { while(q-- > 0) { path[--k] = 'I'; j--; } continue; }
+		for(q = 1; q <= i && (q == i || _in(i - q, j)); q++) {
+			if(_h(i - q, j) + gi + (int64_t)(q - 1) * ge == h) { break; }
+		}
+		if(q <= i && (q == i || _in(i - q, j))) { while(q-- > 0) { path[--k] = 'D'; i--; } continue; }
+		path[0] = '\0';
+		return(-1);
+	}
+	while(i > 0) { path[--k] = 'D'; i--; }
+	while(j > 0) { path[--k] = 'I'; j--; }
+	memmove(path, &path[k], a.len + b.len - k + 1);
+	return(0);
+
+	#undef _h
+	#undef _in
+}
+
+/**
+ * @fn adaptive_affine_intl
+ *
+ * @brief a and b are sequence views (see seq.h). Given st, b is the part fed so far
+ * (all of it if eof): the band resumes from st, and is saved back to it when it
+ * needs a base of b not fed yet (the default policies only). Given xs, the xcnt - 1
+ * thresholds below xt (sorted) are recorded to xr at the vector each would have
+ * ended on (XDROP_CENTER). On COUNT_PATH, the max cell and the matches, aligned
+ * columns, and gap opens on the path to it are left in the maxpos_t at the head of
+ * the work.
+ */
+template<typename T, int P, int D, int S, int G, int Y, int W, int M, int O, int K = COUNT_NONE, typename A, typename B>
+static inline
+int
+adaptive_affine_intl(
+	void *work,
+	A const &a,
+	B const &b,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw,
+	uint32_t *loss = NULL,
+	int8_t gi2 = 0, int8_t ge2 = 0,		/* the second gap pair of GAP_DUAL */
+	char *path = NULL,					/* ALIGN_GLOBAL: alen + blen + 1 chars for the path, or NULL */
+	stream_t *st = NULL, uint64_t eof = 1,
+	int16_t const *xs = NULL, uint64_t xcnt = 0, xdrop_result_t *xr = NULL)
+{
+	typedef vec_t<T> vec;
+	typedef char_vec_t<T> char_vec;
+
+	uint64_t const alen = a.len, blen = b.len;
+	if(loss != NULL) { *loss = 0; }
+	if(O == ALIGN_GLOBAL && (alen == 0 || blen == 0)) {
+		/* nothing to align against, a single gap */
+		if(path != NULL) { memset(path, alen == 0 ? 'I' : 'D', alen + blen); path[alen + blen] = '\0'; }
+		return(alen + blen == 0 ? 0 : gi + (int32_t)(alen + blen) * ge);
+	}
+	if(st != NULL) {
+		/* streaming: nothing left once done, and not started before bw / 2 bases of b */
+		bw = st->bw;
+		if(st->flag & STREAM_DONE) { return(st->score); }
+		if(!(st->flag & STREAM_STARTED) && blen < bw / 2 && !eof) { return(0); }
+		if(alen == 0 || blen == 0) { st->flag |= STREAM_DONE; st->score = 0; }
+	}
+	if(alen == 0 || blen == 0) {
+		for(uint64_t k = 0; k < xcnt; k++) { xr[k] = (xdrop_result_t){ 0, 0, 0 }; }
+		return(0);
+	}
+	debug("%llu, %llu", alen, blen);
+
+	/* extract max and min */
+	score_s<T, A> const sc(a, score_matrix);
+	int8_t sc_max = sc.max;
+	int8_t sc_min = sc.min;
+	/* fix gap open penalty; linear gaps cost ge from the first base */
+	if(M == GAP_LINEAR) { gi = 0; }
+	gi += ge; gi2 += ge2;
+
+	uint64_t const L = vec::LEN;
+	typedef band_s<vec::LEN, Y, M, K> band;
+	static_assert(2 * vec::LEN == vec::SIZE, "a block of chars or scores must be a vector");
+	static_assert(W % vec::LEN == 0 && (W == 0 || G == BAND_STATIC), "compile-time width must be static and a multiple of the vector");
+	static_assert(M != GAP_DUAL || (W == 0 && G == BAND_STATIC), "the second gap pair is on the static band at runtime width only");
+	static_assert(O == ALIGN_EXTEND || (W == 0 && G == BAND_STATIC), "local, end-free, and global modes are on the static band at runtime width only");
+	static_assert(O != ALIGN_GLOBAL || M != GAP_DUAL, "the global path is traced on a single gap pair");
+	static_assert(K == COUNT_NONE || (P == XDROP_CENTER && D == DIR_BRANCH && G == BAND_STATIC && W == 0 && M == GAP_AFFINE && O == ALIGN_EXTEND),
+		"the path counters are on the branching static affine extension only");
+
+	/* compile-time band width (the short-read fast path), or the one given */
+	if(W != 0) { bw = W; }
+
+	/* lanes (and a pad vector) after maxpos_t, the stored vectors after them (see util.h) */
+	uint64_t const wcnt = (G == BAND_DYNAMIC ? WIDEN_MAX : 1) * bw / L + 1;
+	uint8_t *const head = (uint8_t *)work + arena_roundup(sizeof(maxpos_t));
+	band const w(head, wcnt);
+	uint16_t *ptr = (uint16_t *)(head + band::size(wcnt));
+
+	uint64_t const resume = st != NULL && (st->flag & STREAM_STARTED);
+	if(resume) {
+		band_load(w, st->lane, bw, gi, ge, sc_min);
+	} else if(W == 0) {
+		band_init<T>(w, bw, gi, ge, sc_max, sc_min, ge2);
+	} else {
+		/* the initial state depends only on the scoring at a fixed width; built once per thread */
+		static __thread struct {
+			uint8_t img[12 * (W + vec::LEN)] __attribute__(( aligned(ARENA_ALIGN) ));
+			uint64_t key;
+		} cache;
+		typedef band_s<vec::LEN, LAYOUT_AOS> image;
+		image const v(cache.img, wcnt);
+		uint64_t const key = 0x100000000ULL | ((uint64_t)(uint8_t)gi<<24) | ((uint64_t)(uint8_t)ge<<16)
+			| ((uint64_t)(uint8_t)sc_max<<8) | (uint64_t)(uint8_t)sc_min;
+		if(cache.key != key) {
+			band_init<T>(v, bw, gi, ge, sc_max, sc_min);
+			cache.key = key;
+		}
+		band_copy<T>(w, v, wcnt);
+	}
+
+	/* the first bw / 2 chars of each sequence */
+	for(uint64_t i = 0; i < (resume ? 0 : (uint64_t)bw / 2); i++) {
+		w[(bw / 2 - i - 1) / L].a[(bw / 2 - i - 1) % L] = i < alen ? a.encode_a(i) : encode_n();
+		w[(bw / 2 + i) / L].b[(bw / 2 + i) % L] = i < blen ? b.encode_b(i) : encode_n();
+	}
+
 
 	/* direction determiner */
 	uint64_t const RR = 0, RD = 1, DR = 2, DD = 3;
@@ -91,32 +671,200 @@ adaptive_affine(
 
 	uint64_t apos = bw / 2;
 	uint64_t bpos = bw / 2;
+	if(resume) { dir = st->dir; apos = st->apos; bpos = st->bpos; }
 	// vec mv(m), xv(x), giv(-gi), gev(-ge);
-	vec smv, giv(-gi), gev(-ge); smv.load(score_matrix);
-	for(uint64_t p = 0; p < (uint64_t)(alen+blen-1); p++) {
+	vec giv(-gi), gev(-ge), giv2(-gi2), gev2(-ge2);
+
+	/* ALIGN_LOCAL: the zero floor, lowered with the rebase; the cells before the first anti-diagonal on it */
+	vec zv((uint16_t)OFS);
+	if(O == ALIGN_LOCAL) {
+		for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) { zv.store(w[i].pv); zv.store(w[i].cv); zv.store(w[i].max); }
+	}
+
+	/* ALIGN_ENDFREE: the best cell on the last row or column so far, floored at zero */
+	int64_t ebest = 0;
+
+	/* ALIGN_GLOBAL: apos and the base of each anti-diagonal, after its stored vectors */
+	glog_s *glog = (glog_s *)(ptr + bw * (alen + blen));
+
+	/* max so far and its diagonal (apos - bpos), for XDROP_BAND and ZDROP */
+	uint64_t gmax = OFS;
+	int64_t gdiag = 0, gbase = 0;
+	uint16_t const *gptr = NULL;				/* stored vector holding the max, lane not located yet */
+	uint32_t gbw = bw;							/* band width when gptr was stored */
+
+	/* COUNT_PATH: the max cell so far and its counters, and the matches of a pair of chars (the table index of full.c's 'M') */
+	uint64_t kapos = 0, kbpos = 0, kcnt[COUNT_FIELDS] = { 0 };
+	int8_t mt[16] __attribute__(( aligned(16) ));
+	for(uint64_t i = 0; i < 16; i++) { mt[i] = (i & 0x03) == (i>>2) ? -1 : 0; }
+	vec const mtv = vec::table(mt);
+
+	/* BAND_DYNAMIC: pressure counters, the max so far, and the max of the dropped lanes */
+	uint32_t const bw_min = bw, bw_max = WIDEN_MAX * bw;
+	uint64_t pcnt = 0, ncnt = 0, dmax = 0, smax = OFS;
+
+	/* offset removed from the cells so far, and vectors to the next rebase test */
+	uint64_t const rspan = MAX2(1, REBASE_SPAN / MAX2(1, O == ALIGN_GLOBAL ? MAX3(sc_max, -sc_min, -gi) : sc_max));
+	uint64_t rbase = resume ? st->rbase : 0, rcnt = resume ? st->rcnt : rspan;
+	uint64_t p, susp = 0, xk = 0;
+	for(p = resume ? st->p : 0; p < (uint64_t)(alen+blen-1); p++) {
 		debug("%lld, %d, %d", dir, w[bw / L - 1].cv[L - 1], w[0].cv[0]);
-		dir = dir_trans[w[bw / L - 1].cv[L - 1] > w[0].cv[0]][dir];
+		if(--rcnt == 0) {
+			rcnt = rspan;
+			vec bmax((uint16_t)MIN);
+			/* global: the current cells, as the max of each lane stays behind on the band going down */
+			for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) { vec t(O == ALIGN_GLOBAL ? w[i].cv : w[i].max); bmax = vec::max(bmax, t); }
+			uint64_t const m = bmax.hmax();
+			if(m > REBASE_THRESH) {
+				debug("rebase(%llu)", m - OFS);
+				/* the stored vectors are not rebased; locate the max before they go stale */
+				if(P == ZDROP && gptr != NULL) { gdiag = gbase - 2 * find_lane<T>(gptr, gmax, gbw); gptr = NULL; }
+
+				uint64_t const d = m - OFS;
+				vec const dv((uint16_t)d);
+				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
+					vec tp(w[i].pv), tv(w[i].cv), tm(w[i].max);
+					(tp - dv).store(w[i].pv); (tv - dv).store(w[i].cv);
+					(tm - dv).store(w[i].max);
+					if(M != GAP_LINEAR) {
+						vec te(w[i].ce), tf(w[i].cf);
+						(te - dv).store(w[i].ce); (tf - dv).store(w[i].cf);
+					}
+					if(M == GAP_DUAL) {
+						vec te(w[i].ce2), tf(w[i].cf2);
+						(te - dv).store(w[i].ce2); (tf - dv).store(w[i].cf2);
+					}
+				}
+				gmax = gmax > d ? gmax - d : MIN;
+				smax = smax > d ? smax - d : MIN;
+				dmax = dmax > d ? dmax - d : MIN;
+				zv -= dv;
+				rbase += d;
+			} else if(O == ALIGN_GLOBAL && m + (REBASE_THRESH - OFS) < OFS) {
+				/* global: no X-drop to stop the band going down; brought back up the same way (the max unused) */
+				debug("rebase(-%llu)", OFS - m);
+				uint64_t const d = OFS - m;
+				vec const dv((uint16_t)d);
+				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
+					vec tp(w[i].pv), tv(w[i].cv), te(w[i].ce), tf(w[i].cf);
+					(tp + dv).store(w[i].pv); (tv + dv).store(w[i].cv);
+					if(M != GAP_LINEAR) { (te + dv).store(w[i].ce); (tf + dv).store(w[i].cf); }
+				}
+				rbase -= d;
+			}
+		}
+
+		uint64_t down = steer<T, S>(w, bw, dir, gi, ge);
+		if(st != NULL && !eof && down && bpos >= blen) {
+			/* the next base of b is not fed yet; the rebase counter taken back to redo this vector */
+			rcnt++; susp = 1;
+			break;
+		}
+		if(O == ALIGN_GLOBAL) {
+			/* toward the diagonal of (alen, blen), forced once the drift from it takes all the vectors left */
+			int64_t const drift = (int64_t)(apos - bpos) - (int64_t)(alen - blen), rest = alen + blen - 1 - p;
+			if(drift >= rest) { down = 1; }
+			if(-drift >= rest) { down = 0; }
+		}
+		dir = dir_trans[down][dir];
+		vec rmax((uint16_t)MIN);
 
 		// dump(w.pv, sizeof(uint16_t) * bw);
 		// dump(w.cv, sizeof(uint16_t) * bw);
 		// dump(w.ce, sizeof(uint16_t) * bw);
 		// dump(w.cf, sizeof(uint16_t) * bw);
 
-		switch(dir & 0x03) {
+		if(D == DIR_BLEND) {
+			/* both shifts calculated, selected with the direction masks instead of branching on dir */
+			uint64_t const d = dir & 0x01;
+			vec const dv((uint16_t)-d);					/* down */
+			vec const ddv((uint16_t)-(dir == DD)), rrv((uint16_t)-(dir == RR));
+			char_vec const dc((int8_t)-d), rc((int8_t)(d - 1));
+
+			w[bw / L].b[0] = bpos < blen ? b.encode_b(bpos) : encode_n();
+			char_vec ca((int8_t const)(apos < alen ? a.encode_a(apos) : encode_n()));
+			bpos += d; apos += 1 - d;
+
+			/* c*: the current block, p*: the previous one (before update) */
+			char_vec cb(w[0].b);
+			vec ch(w[0].cv), ph(-gi), ce(w[0].ce), pf(-ge), cd(w[0].pv), pd(-sc_min), ce2(w[0].ce2), pf2(-ge2);
+			for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
+				debug("loop: %llu", i);
+				char_vec ta(w[i].a), tb(w[i + 1].b);
+				char_vec va = (ta & dc) | (ta.dsl(ca) & rc), vb = (tb.dsr(cb) & dc) | (cb & rc);
+				ca = ta; cb = tb;
+				va.store(w[i].a); vb.store(w[i].b);
+
+				va.print("va"); vb.print("vb");
+				vec scv = sc(va, vb);
+
+				/* load pv: shifted down on DD, right on RR */
+				vec td(w[i + 1].pv), vd = ddv.select(td.dsr(cd), rrv.select(cd.dsl(pd), cd));
+				pd = cd; cd = td;
+
+				/* load v and h */
+				vec th(w[i + 1].cv);
+				vec vh = dv.select(th.dsr(ch), ch), vv = dv.select(ch, ch.dsl(ph));
+				ch.store(w[i].pv); ph = ch; ch = th;
+
+				/* update s; straight from the neighbors on linear gaps, without e and f */
+				vec nv;
+				if(M == GAP_LINEAR) {
+					nv = vec::max(vec::max(vh, vv) - gev, vd + scv);
+				} else {
+					/* load f and e */
+					vec te(w[i + 1].ce), tf(w[i].cf);
+					vec ve = dv.select(te.dsr(ce), ce), vf = dv.select(tf, tf.dsl(pf));
+					ce = te; pf = tf;
+
+					/* update e and f */
+					vec ne = vec::max(vh - giv, ve - gev);
+					vec nf = vec::max(vv - giv, vf - gev);
+					ne.store(w[i].ce); ne.print();
+					nf.store(w[i].cf); nf.print();
+
+					nv = vec::max(vec::max(ne, nf), vd + scv);
+					if(M == GAP_DUAL) {
+						/* the second pair, the same recurrence */
+						vec te2(w[i + 1].ce2), tf2(w[i].cf2);
+						vec ve2 = dv.select(te2.dsr(ce2), ce2), vf2 = dv.select(tf2, tf2.dsl(pf2));
+						ce2 = te2; pf2 = tf2;
+						vec ne2 = vec::max(vh - giv2, ve2 - gev2);
+						vec nf2 = vec::max(vv - giv2, vf2 - gev2);
+						ne2.store(w[i].ce2); ne2.print();
+						nf2.store(w[i].cf2); nf2.print();
+						nv = vec::max(nv, vec::max(ne2, nf2));
+					}
+				}
+				if(O == ALIGN_LOCAL) { nv = vec::max(nv, zv); }
+				nv.store(w[i].cv); nv.print();
+				nv.store(&ptr[L*i]);
+				if(P != XDROP_CENTER || G == BAND_DYNAMIC) { rmax = vec::max(rmax, nv); }
+
+				vec t(w[i].max); t = vec::max(t, nv);
+				t.store(w[i].max);
+			}
+		} else switch(dir & 0x03) {
 			case DD: {
 				debug("DD");
-				w[bw / L].b[0] = bpos < blen ? encode_b(b[bpos]) : encode_n();
+				w[bw / L].b[0] = bpos < blen ? b.encode_b(bpos) : encode_n();
 				bpos++;
 
 				char_vec cb(w[0].b);
-				vec ch(w[0].cv), ce(w[0].ce), cd(w[0].pv);
+				vec ch(w[0].cv), ce(w[0].ce), cd(w[0].pv), ce2(w[0].ce2);
+
+				/* COUNT_PATH: the same for the counters */
+				vec kcd[COUNT_FIELDS], kch[COUNT_FIELDS], kce[COUNT_FIELDS];
+				for(uint64_t k = 0; k < (K == COUNT_PATH ? COUNT_FIELDS : 0); k++) {
+					kcd[k] = vec(w[0].pk(k)); kch[k] = vec(w[0].ck(k)); kce[k] = vec(w[0].ek(k));
+				}
 				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
 					debug("loop: %llu", i);
 					char_vec va(w[i].a), tb(w[i + 1].b), vb = tb.dsr(cb);
 					cb = tb; vb.store(w[i].b);
 
 					va.print("va"); vb.print("vb");
-					vec scv = smv.shuffle(va | vb);
+					vec scv = sc(va, vb);
 
 					/* load pv */
 					vec td(w[i + 1].pv), vd = td.dsr(cd);
@@ -126,20 +874,45 @@ adaptive_affine(
 					vec th(w[i + 1].cv), vv = ch, vh = th.dsr(ch);
 					ch.store(w[i].pv); ch = th;
 
-					/* load f and e */
-					vec te(w[i + 1].ce), vf(w[i].cf), ve = te.dsr(ce);
-					ce = te;
-
-					/* update e and f */
-					vec ne = vec::max(vh - giv, ve - gev);
-					vec nf = vec::max(vv - giv, vf - gev);
-					ne.store(w[i].ce); ne.print();
-					nf.store(w[i].cf); nf.print();
-
-					/* update s */
-					vec nv = vec::max(vec::max(ne, nf), vd + scv);
+					/* update s; straight from the neighbors on linear gaps, without e and f */
+					vec nv;
+					if(M == GAP_LINEAR) {
+						nv = vec::max(vec::max(vh, vv) - gev, vd + scv);
+					} else {
+						/* load f and e */
+						vec te(w[i + 1].ce), vf(w[i].cf), ve = te.dsr(ce);
+						ce = te;
+
+						/* update e and f */
+						vec ne = vec::max(vh - giv, ve - gev);
+						vec nf = vec::max(vv - giv, vf - gev);
+						ne.store(w[i].ce); ne.print();
+						nf.store(w[i].cf); nf.print();
+
+						nv = vec::max(vec::max(ne, nf), vd + scv);
+						if(M == GAP_DUAL) {
+							/* the second pair, the same recurrence */
+							vec te2(w[i + 1].ce2), vf2(w[i].cf2), ve2 = te2.dsr(ce2);
+							ce2 = te2;
+							vec ne2 = vec::max(vh - giv2, ve2 - gev2);
+							vec nf2 = vec::max(vv - giv2, vf2 - gev2);
+							ne2.store(w[i].ce2); ne2.print();
+							nf2.store(w[i].cf2); nf2.print();
+							nv = vec::max(nv, vec::max(ne2, nf2));
+						}
+						if(K == COUNT_PATH) {
+							count_s<T> const q(mtv, va, vb, gev, ve, vf, ne, nf, nv);
+							for(uint64_t k = 0; k < COUNT_FIELDS; k++) {
+								vec const tkd(w[i + 1].pk(k)), tkh(w[i + 1].ck(k)), tke(w[i + 1].ek(k));
+								q.update(w, i, k, kch[k], tkd.dsr(kcd[k]), tkh.dsr(kch[k]), kch[k], tke.dsr(kce[k]), vec(w[i].fk(k)));
+								kcd[k] = tkd; kch[k] = tkh; kce[k] = tke;
+							}
+						}
+					}
+					if(O == ALIGN_LOCAL) { nv = vec::max(nv, zv); }
 					nv.store(w[i].cv); nv.print();
-					nv.store(&ptr[L*i]);
+					if(K == COUNT_NONE) { nv.store(&ptr[L*i]); }
+					if(P != XDROP_CENTER || G == BAND_DYNAMIC || K == COUNT_PATH) { rmax = vec::max(rmax, nv); }
 
 					vec t; t.load(w[i].max); t = vec::max(t, nv);
 					t.store(w[i].max);
@@ -147,18 +920,24 @@ adaptive_affine(
 			} break;
 			case RD: {
 				debug("RD");
-				w[bw / L].b[0] = bpos < blen ? encode_b(b[bpos]) : encode_n();
+				w[bw / L].b[0] = bpos < blen ? b.encode_b(bpos) : encode_n();
 				bpos++;
 
 				char_vec cb(w[0].b);
-				vec ch(w[0].cv), ce(w[0].ce);
+				vec ch(w[0].cv), ce(w[0].ce), ce2(w[0].ce2);
+
+				/* COUNT_PATH: the same for the counters */
+				vec kch[COUNT_FIELDS], kce[COUNT_FIELDS];
+				for(uint64_t k = 0; k < (K == COUNT_PATH ? COUNT_FIELDS : 0); k++) {
+					kch[k] = vec(w[0].ck(k)); kce[k] = vec(w[0].ek(k));
+				}
 				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
 					debug("loop: %llu", i);
 					char_vec va(w[i].a), tb(w[i + 1].b), vb = tb.dsr(cb);
 					cb = tb; vb.store(w[i].b);
 
 					va.print("va"); vb.print("vb");
-					vec scv = smv.shuffle(va | vb);
+					vec scv = sc(va, vb);
 
 					/* load pv */
 					vec vd(w[i].pv);
@@ -167,20 +946,45 @@ adaptive_affine(
 					vec th(w[i + 1].cv), vv = ch, vh = th.dsr(ch);
 					ch.store(w[i].pv); ch = th;
 
-					/* load f and e */
-					vec te(w[i + 1].ce), vf(w[i].cf), ve = te.dsr(ce);
-					ce = te;
-
-					/* update e and f */
-					vec ne = vec::max(vh - giv, ve - gev);
-					vec nf = vec::max(vv - giv, vf - gev);
-					ne.store(w[i].ce); ne.print();
-					nf.store(w[i].cf); nf.print();
-
-					/* update s */
-					vec nv = vec::max(vec::max(ne, nf), vd + scv);
+					/* update s; straight from the neighbors on linear gaps, without e and f */
+					vec nv;
+					if(M == GAP_LINEAR) {
+						nv = vec::max(vec::max(vh, vv) - gev, vd + scv);
+					} else {
+						/* load f and e */
+						vec te(w[i + 1].ce), vf(w[i].cf), ve = te.dsr(ce);
+						ce = te;
+
+						/* update e and f */
+						vec ne = vec::max(vh - giv, ve - gev);
+						vec nf = vec::max(vv - giv, vf - gev);
+						ne.store(w[i].ce); ne.print();
+						nf.store(w[i].cf); nf.print();
+
+						nv = vec::max(vec::max(ne, nf), vd + scv);
+						if(M == GAP_DUAL) {
+							/* the second pair, the same recurrence */
+							vec te2(w[i + 1].ce2), vf2(w[i].cf2), ve2 = te2.dsr(ce2);
+							ce2 = te2;
+							vec ne2 = vec::max(vh - giv2, ve2 - gev2);
+							vec nf2 = vec::max(vv - giv2, vf2 - gev2);
+							ne2.store(w[i].ce2); ne2.print();
+							nf2.store(w[i].cf2); nf2.print();
+							nv = vec::max(nv, vec::max(ne2, nf2));
+						}
+						if(K == COUNT_PATH) {
+							count_s<T> const q(mtv, va, vb, gev, ve, vf, ne, nf, nv);
+							for(uint64_t k = 0; k < COUNT_FIELDS; k++) {
+								vec const tkh(w[i + 1].ck(k)), tke(w[i + 1].ek(k));
+								q.update(w, i, k, kch[k], vec(w[i].pk(k)), tkh.dsr(kch[k]), kch[k], tke.dsr(kce[k]), vec(w[i].fk(k)));
+								kch[k] = tkh; kce[k] = tke;
+							}
+						}
+					}
+					if(O == ALIGN_LOCAL) { nv = vec::max(nv, zv); }
 					nv.store(w[i].cv); nv.print();
-					nv.store(&ptr[L*i]);
+					if(K == COUNT_NONE) { nv.store(&ptr[L*i]); }
+					if(P != XDROP_CENTER || G == BAND_DYNAMIC || K == COUNT_PATH) { rmax = vec::max(rmax, nv); }
 
 					vec t; t.load(w[i].max); t = vec::max(t, nv);
 					t.store(w[i].max);
@@ -188,17 +992,23 @@ adaptive_affine(
 			} break;
 			case DR: {
 				debug("DR");
-				char_vec ca((int8_t const)(apos < alen ? encode_a(a[apos]) : encode_n()));
+				char_vec ca((int8_t const)(apos < alen ? a.encode_a(apos) : encode_n()));
 				apos++;
 
-				vec cv(-gi), cf(-ge);
+				vec cv(-gi), cf(-ge), cf2(-ge2);
+
+				/* COUNT_PATH: the same for the counters, zero on the pads */
+				vec kcv[COUNT_FIELDS], kcf[COUNT_FIELDS];
+				for(uint64_t k = 0; k < (K == COUNT_PATH ? COUNT_FIELDS : 0); k++) {
+					kcv[k] = kcf[k] = vec((uint16_t)0);
+				}
 				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
 					debug("loop: %llu", i);
 					char_vec ta(w[i].a), va = ta.dsl(ca), vb(w[i].b);
 					ca = ta; va.store(w[i].a);
 
 					va.print("va"); vb.print("vb");
-					vec scv = smv.shuffle(va | vb);
+					vec scv = sc(va, vb);
 
 					/* load pv */
 					vec vd(w[i].pv);
@@ -207,20 +1017,45 @@ adaptive_affine(
 					vec tv(w[i].cv), vh = tv, vv = tv.dsl(cv);
 					tv.store(w[i].pv); cv = tv;
 
-					/* load f and e */
-					vec ve(w[i].ce), tf(w[i].cf), vf = tf.dsl(cf);
-					cf = tf;
-
-					/* update e and f */
-					vec ne = vec::max(vh - giv, ve - gev);
-					vec nf = vec::max(vv - giv, vf - gev);
-					ne.store(w[i].ce); ne.print();
-					nf.store(w[i].cf); nf.print();
-
-					/* update s */
-					vec nv = vec::max(vec::max(ne, nf), vd + scv);
+					/* update s; straight from the neighbors on linear gaps, without e and f */
+					vec nv;
+					if(M == GAP_LINEAR) {
+						nv = vec::max(vec::max(vh, vv) - gev, vd + scv);
+					} else {
+						/* load f and e */
+						vec ve(w[i].ce), tf(w[i].cf), vf = tf.dsl(cf);
+						cf = tf;
+
+						/* update e and f */
+						vec ne = vec::max(vh - giv, ve - gev);
+						vec nf = vec::max(vv - giv, vf - gev);
+						ne.store(w[i].ce); ne.print();
+						nf.store(w[i].cf); nf.print();
+
+						nv = vec::max(vec::max(ne, nf), vd + scv);
+						if(M == GAP_DUAL) {
+							/* the second pair, the same recurrence */
+							vec ve2(w[i].ce2), tf2(w[i].cf2), vf2 = tf2.dsl(cf2);
+							cf2 = tf2;
+							vec ne2 = vec::max(vh - giv2, ve2 - gev2);
+							vec nf2 = vec::max(vv - giv2, vf2 - gev2);
+							ne2.store(w[i].ce2); ne2.print();
+							nf2.store(w[i].cf2); nf2.print();
+							nv = vec::max(nv, vec::max(ne2, nf2));
+						}
+						if(K == COUNT_PATH) {
+							count_s<T> const q(mtv, va, vb, gev, ve, vf, ne, nf, nv);
+							for(uint64_t k = 0; k < COUNT_FIELDS; k++) {
+								vec const tkv(w[i].ck(k)), tkf(w[i].fk(k));
+								q.update(w, i, k, tkv, vec(w[i].pk(k)), tkv, tkv.dsl(kcv[k]), vec(w[i].ek(k)), tkf.dsl(kcf[k]));
+								kcv[k] = tkv; kcf[k] = tkf;
+							}
+						}
+					}
+					if(O == ALIGN_LOCAL) { nv = vec::max(nv, zv); }
 					nv.store(w[i].cv); nv.print();
-					nv.store(&ptr[L*i]);
+					if(K == COUNT_NONE) { nv.store(&ptr[L*i]); }
+					if(P != XDROP_CENTER || G == BAND_DYNAMIC || K == COUNT_PATH) { rmax = vec::max(rmax, nv); }
 
 					vec t(w[i].max); t = vec::max(t, nv);
 					t.store(w[i].max);
@@ -229,19 +1064,25 @@ adaptive_affine(
 			case RR: {
 				debug("RR");
 
-				char_vec ca((int8_t const)(apos < alen ? encode_a(a[apos]) : encode_n()));
+				char_vec ca((int8_t const)(apos < alen ? a.encode_a(apos) : encode_n()));
 				apos++;
 
 				vec cv(-gi);
-				vec cf(-ge);
+				vec cf(-ge), cf2(-ge2);
 				vec cd(-sc_min);
+
+				/* COUNT_PATH: the same for the counters, zero on the pads */
+				vec kcd[COUNT_FIELDS], kcv[COUNT_FIELDS], kcf[COUNT_FIELDS];
+				for(uint64_t k = 0; k < (K == COUNT_PATH ? COUNT_FIELDS : 0); k++) {
+					kcd[k] = kcv[k] = kcf[k] = vec((uint16_t)0);
+				}
 				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
 					debug("loop: %llu", i);
 					char_vec ta(w[i].a), va = ta.dsl(ca), vb(w[i].b);
 					ca = ta; va.store(w[i].a);
 
 					va.print("va"); vb.print("vb");
-					vec scv = smv.shuffle(va | vb);
+					vec scv = sc(va, vb);
 
 					/* load pv */
 					vec td(w[i].pv), vd = td.dsl(cd);
@@ -252,20 +1093,45 @@ adaptive_affine(
 					vec vh = tv, vv = tv.dsl(cv);
 					tv.store(w[i].pv); cv = tv;
 
-					/* load f and e */
-					vec ve(w[i].ce), tf(w[i].cf), vf = tf.dsl(cf);
-					cf = tf;
-
-					/* update e and f */
-					vec ne = vec::max(vh - giv, ve - gev);
-					vec nf = vec::max(vv - giv, vf - gev);
-					ne.store(w[i].ce); ne.print();
-					nf.store(w[i].cf); nf.print();
-
-					/* update s */
-					vec nv = vec::max(vec::max(ne, nf), vd + scv);
+					/* update s; straight from the neighbors on linear gaps, without e and f */
+					vec nv;
+					if(M == GAP_LINEAR) {
+						nv = vec::max(vec::max(vh, vv) - gev, vd + scv);
+					} else {
+						/* load f and e */
+						vec ve(w[i].ce), tf(w[i].cf), vf = tf.dsl(cf);
+						cf = tf;
+
+						/* update e and f */
+						vec ne = vec::max(vh - giv, ve - gev);
+						vec nf = vec::max(vv - giv, vf - gev);
+						ne.store(w[i].ce); ne.print();
+						nf.store(w[i].cf); nf.print();
+
+						nv = vec::max(vec::max(ne, nf), vd + scv);
+						if(M == GAP_DUAL) {
+							/* the second pair, the same recurrence */
+							vec ve2(w[i].ce2), tf2(w[i].cf2), vf2 = tf2.dsl(cf2);
+							cf2 = tf2;
+							vec ne2 = vec::max(vh - giv2, ve2 - gev2);
+							vec nf2 = vec::max(vv - giv2, vf2 - gev2);
+							ne2.store(w[i].ce2); ne2.print();
+							nf2.store(w[i].cf2); nf2.print();
+							nv = vec::max(nv, vec::max(ne2, nf2));
+						}
+						if(K == COUNT_PATH) {
+							count_s<T> const q(mtv, va, vb, gev, ve, vf, ne, nf, nv);
+							for(uint64_t k = 0; k < COUNT_FIELDS; k++) {
+								vec const tkd(w[i].pk(k)), tkv(w[i].ck(k)), tkf(w[i].fk(k));
+								q.update(w, i, k, tkv, tkd.dsl(kcd[k]), tkv, tkv.dsl(kcv[k]), vec(w[i].ek(k)), tkf.dsl(kcf[k]));
+								kcd[k] = tkd; kcv[k] = tkv; kcf[k] = tkf;
+							}
+						}
+					}
+					if(O == ALIGN_LOCAL) { nv = vec::max(nv, zv); }
 					nv.store(w[i].cv); nv.print();
-					nv.store(&ptr[L*i]);
+					if(K == COUNT_NONE) { nv.store(&ptr[L*i]); }
+					if(P != XDROP_CENTER || G == BAND_DYNAMIC || K == COUNT_PATH) { rmax = vec::max(rmax, nv); }
 
 					vec t(w[i].max); t = vec::max(t, nv);
 					t.store(w[i].max);
@@ -274,19 +1140,977 @@ adaptive_affine(
 		}
 		ptr += bw;
 
-		if(w[bw / 2 / L].cv[0] < w[bw / 2 / L].max[0] - xt) {
-			debug("xdrop");
+		if(O == ALIGN_ENDFREE) {
+			/* lane l is on (apos - l, bpos - bw + 1 + l): the last row on lane apos - alen, the last column on blen + bw - 1 - bpos */
+			uint16_t const *q = ptr - bw;
+			uint64_t const la = apos - alen, lb = blen + bw - 1 - bpos;
+			if(la < bw && bpos + la >= bw && bpos + la + 1 - bw <= blen) { ebest = MAX2(ebest, (int64_t)q[la] - OFS + (int64_t)rbase); }
+			if(lb < bw && apos > lb && apos - lb <= alen) { ebest = MAX2(ebest, (int64_t)q[lb] - OFS + (int64_t)rbase); }
+		}
+
+		if(G == BAND_DYNAMIC) {
+			/* pressure: the max dropping behind */
+			uint64_t const m = rmax.hmax();
+			smax = MAX2(smax, m);
+			pcnt = m + xt / WIDEN_DROP < smax ? pcnt + 1 : 0;
+			ncnt = pcnt == 0 ? ncnt + 1 : 0;
+
+			/* lanes are resized by H on both sides, keeping the center lane on the same diagonal */
+			uint64_t const H = L / 2;
+			#define _move_lane(_d, _s) { \
+				w[(_d) / L].a[(_d) % L] = w[(_s) / L].a[(_s) % L]; \
+				w[(_d) / L].b[(_d) % L] = w[(_s) / L].b[(_s) % L]; \
+				w[(_d) / L].pv[(_d) % L] = w[(_s) / L].pv[(_s) % L]; \
+				w[(_d) / L].cv[(_d) % L] = w[(_s) / L].cv[(_s) % L]; \
+				w[(_d) / L].ce[(_d) % L] = w[(_s) / L].ce[(_s) % L]; \
+				w[(_d) / L].cf[(_d) % L] = w[(_s) / L].cf[(_s) % L]; \
+				w[(_d) / L].max[(_d) % L] = w[(_s) / L].max[(_s) % L]; \
+			}
+			/* cells of a new lane q lanes out of the edge e, decreased the same as the init (so
+			   that the steering keeps working); kept above -sc_min not to wrap on adding the score */
+			#define _dec(_x, _e, _q)	( MAX2((int64_t)w[(_e) / L]._x[(_e) % L] + (int64_t)(_q) * (2*gi - sc_max), (int64_t)-sc_min) )
+			#define _init_lane(_l, _e, _q) { \
+				w[(_l) / L].pv[(_l) % L] = _dec(pv, _e, _q); \
+				w[(_l) / L].cv[(_l) % L] = _dec(cv, _e, _q); \
+				w[(_l) / L].ce[(_l) % L] = _dec(ce, _e, _q); \
+				w[(_l) / L].cf[(_l) % L] = _dec(cf, _e, _q); \
+				w[(_l) / L].max[(_l) % L] = 0; \
+			}
+			if(pcnt >= WIDEN_STEPS && bw < bw_max) {
+				/* lane l stays at (apos - 1 - l, bpos - bw + l) after apos, bpos += H and bw += 2H */
+				debug("widen");
+				for(uint64_t l = bw; l > 0; l--) { _move_lane(l - 1 + H, l - 1); }
+				for(uint64_t k = 0; k < H; k++) {
+					/* lower (a) side, lane k */
+					int64_t ib = (int64_t)bpos - (int64_t)(bw + H) + (int64_t)k;
+					w[k / L].a[k % L] = apos + H - 1 - k < alen ? a.encode_a(apos + H - 1 - k) : encode_n();
+					w[k / L].b[k % L] = ib < 0 ? 0xff : ((uint64_t)ib < blen ? b.encode_b(ib) : encode_n());
+					_init_lane(k, H, H - k);
+
+					/* upper (b) side, lane bw + H + k */
+					uint64_t u = bw + H + k;
+					int64_t ia = (int64_t)apos - 1 - (int64_t)(bw + k);
+					w[u / L].a[u % L] = ia < 0 ? 0x80 : ((uint64_t)ia < alen ? a.encode_a(ia) : encode_n());
+					w[u / L].b[u % L] = bpos + k < blen ? b.encode_b(bpos + k) : encode_n();
+					_init_lane(u, bw + H - 1, k + 1);
+				}
+				bw += 2 * H; apos += H; bpos += H;
+				band_pad(w, bw / L, gi, ge, sc_min);
+				pcnt = 0;
+			} else if(ncnt >= NARROW_STEPS && bw > bw_min) {
+				debug("narrow");
+				for(uint64_t k = 0; k < H; k++) {
+					dmax = MAX2(dmax, w[k / L].max[k % L]);
+					dmax = MAX2(dmax, w[(bw - 1 - k) / L].max[(bw - 1 - k) % L]);
+				}
+				for(uint64_t l = 0; l < bw - 2 * H; l++) { _move_lane(l, l + H); }
+				bw -= 2 * H; apos -= H; bpos -= H;
+				band_pad(w, bw / L, gi, ge, sc_min);
+				ncnt = 0;
+			}
+			#undef _move_lane
+			#undef _init_lane
+			#undef _dec
+		}
+
+		if(O == ALIGN_GLOBAL) {
+			glog[p] = (glog_s){ (uint32_t)apos, (int32_t)rbase };
+			continue;
+		}
+
+		if(K == COUNT_PATH) {
+			/* a new max: the first lane holding it and its counters; lane l is on (apos - l, bpos - bw + 1 + l) */
+			uint64_t const r = rmax.hmax();
+			if(r > gmax) {
+				uint64_t l = 0;
+				for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
+					uint64_t const m = (vec(w[i].cv) == vec((uint16_t)r));
+					if(m != 0) { l = i * L + tzcnt(m) / 2; break; }
+				}
+				gmax = r; kapos = apos - l; kbpos = bpos - bw + 1 + l;
+				for(uint64_t k = 0; k < COUNT_FIELDS; k++) { kcnt[k] = w[l / L].ck(k)[l % L]; }
+			}
+		}
+
+		if(P == XDROP_CENTER) {
+			/* the smaller thresholds falling on the way to xt; lane bw / 2 is on (apos - bw / 2, bpos - bw / 2 + 1) */
+			while(xk + 1 < xcnt && w[bw / 2 / L].cv[bw / 2 % L] < w[bw / 2 / L].max[bw / 2 % L] - xs[xk]) {
+				xr[xk++] = (xdrop_result_t){ (int64_t)band_max<T>(w, bw) - OFS + (int64_t)rbase, apos - bw / 2, bpos - bw / 2 + 1 };
+			}
+			if(w[bw / 2 / L].cv[bw / 2 % L] < w[bw / 2 / L].max[bw / 2 % L] - xt) {
+				debug("xdrop");
+				break;
+			}
+			continue;
+		}
+
+		uint64_t r = rmax.hmax();
+		if(r > gmax) { gmax = r; gptr = ptr - bw; gbw = bw; gbase = apos - bpos + bw - 1; }
+		if(P == XDROP_BAND && r + xt < gmax) {
+			debug("xdrop (band)");
 			break;
 		}
+		if(P == ZDROP && r + xt < gmax) {
+			/* lane l is on the diagonal apos - bpos + bw - 1 - 2l (see the char vector init) */
+			if(gptr != NULL) { gdiag = gbase - 2 * find_lane<T>(gptr, gmax, gbw); gptr = NULL; }
+			int64_t d = (int64_t)(apos - bpos + bw - 1 - 2 * find_lane<T>(ptr - bw, r, bw)) - gdiag;
+			if(r + xt + (uint64_t)(-ge) * (d < 0 ? -d : d) < gmax) {
+				debug("zdrop");
+				break;
+			}
+		}
 	}
 
-	int32_t max = 0;
-	for(uint64_t i = 0; i < (uint64_t)(bw / L); i++) {
-		vec t(w[i].max);
-		debug("%d", t.hmax());
-		if(t.hmax() > max) { max = t.hmax(); }
+	if(O == ALIGN_ENDFREE) { return(ebest); }
+	if(O == ALIGN_GLOBAL) {
+		/* the end cell is on lane apos - alen of the last vector, held there by the steering */
+		uint16_t const *st = ptr - bw * (alen + blen - 1);
+		if(path != NULL && trace_global(path, st, glog, bw, a, b, score_matrix, gi, ge) != 0) { debug("no path"); }
+		return((int64_t)(ptr - bw)[apos - alen] - OFS + (int64_t)rbase);
+	}
+
+	/* a single horizontal max over the lanes */
+	int32_t max = MAX2((int32_t)dmax, (int32_t)band_max<T>(w, bw));
+	while(xk < xcnt) { xr[xk++] = (xdrop_result_t){ (int64_t)max - OFS + (int64_t)rbase, apos - bw / 2, bpos - bw / 2 + 1 }; }
+
+	if(st != NULL) {
+		/* suspended on b, or at the last vector of the bases fed so far */
+		st->score = (int64_t)max - OFS + rbase;
+		if(susp || (!eof && p == (uint64_t)(alen+blen-1))) {
+			band_save(st->lane, w, bw);
+			st->apos = apos; st->bpos = bpos; st->p = p; st->rbase = rbase;
+			st->dir = dir; st->rcnt = rcnt; st->flag |= STREAM_STARTED;
+		} else {
+			st->flag |= STREAM_DONE;
+		}
+	}
+
+	if(loss != NULL) {
+		int32_t const m = max - bw / 4 * -ge;
+		for(uint64_t i = 0; i < STEER_LANES; i++) {
+			uint64_t const l = i, u = bw - 1 - i;
+			if(w[l / L].max[l % L] >= m || w[u / L].max[u % L] >= m) { *loss |= LOSS_EDGE; }
+		}
+		if(p < (uint64_t)(alen+blen-1)) {
+			for(uint64_t l = 0; l < bw; l += bw - 1) {
+				uint16_t const c = w[l / L].cv[l % L];
+				if(c == w[l / L].max[l % L] && c + xt >= max) { *loss |= LOSS_RISING; }
+			}
+		}
+		debug("loss(%x)", *loss);
 	}
-	return(max - OFS);
+
+	if(K == COUNT_PATH) {
+		/* the band is done with; the diagonal moves from i + j less the gap bases */
+		maxpos_t *r = (maxpos_t *)work;
+		uint64_t const g = MIN2(kcnt[1], kapos + kbpos), d = (kapos + kbpos - g) / 2;
+		r->alen = alen; r->blen = blen;
+		r->apos = kapos; r->bpos = kbpos;
+		r->mcnt = d - MIN2(kcnt[0], d); r->lcnt = d + g; r->ocnt = kcnt[2];
+	}
+	return((int64_t)max - OFS + rbase);
+}
+
+/**
+ * @fn adaptive_affine
+ */
+int
+_isa(adaptive_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	/* short-read fast path */
+	if(bw == SHORT_BW) {
+		return(adaptive_affine_intl<short_isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, SHORT_BW, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+	}
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_stream
+ *
+ * @brief adaptive_affine on b fed as it arrives: b holds the blen bases so far
+ * (eof nonzero once all of them), st the extension as left by the previous
+ * call (stream_init for a new one). Returns the best score so far; st->flag
+ * gets STREAM_DONE once the result is final, the same as adaptive_affine on
+ * the whole b. The work holds the band and a vector per anti-diagonal of the
+ * call only, work_size(st->bw, alen, the bases fed since the previous call).
+ */
+int
+_isa(adaptive_stream)(
+	void *work,
+	stream_t *st,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	uint64_t eof,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, st->bw, NULL, 0, 0, NULL, st, eof));
+}
+
+/**
+ * @fn adaptive_stream_affine
+ *
+ * @brief the bench of adaptive_stream: b fed STREAM_CHUNK bases at a time, the
+ * state handed over between two buffers after each call as to another worker
+ */
+int
+_isa(adaptive_stream_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	static __thread uint8_t buf[2][STREAM_SIZE(BW_MAX)] __attribute__(( aligned(ARENA_ALIGN) ));
+	stream_t *st = (stream_t *)buf[0];
+	stream_init(st, bw);
+
+	int32_t s = 0;
+	for(uint64_t l = MIN2(blen, STREAM_CHUNK), k = 0;; l = MIN2(blen, l + STREAM_CHUNK), k ^= 1) {
+		s = _isa(adaptive_stream)(work, st, a, alen, b, l, l == blen, score_matrix, gi, ge, xt);
+		if(st->flag & STREAM_DONE) { break; }
+		memcpy(buf[k ^ 1], st, STREAM_SIZE(bw));
+		st = (stream_t *)buf[k ^ 1];
+	}
+	return(s);
+}
+
+/**
+ * @fn adaptive_mx
+ *
+ * @brief adaptive_affine at each of the xcnt thresholds of xt (sorted ascending) in
+ * a single pass at the largest, the score and the center cell it ended on to xr;
+ * X only ends the band, so each is the same as a run at it alone
+ */
+int
+_isa(adaptive_mx)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t const *xt, uint64_t xcnt, uint32_t bw,
+	xdrop_result_t *xr)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt[xcnt - 1], bw, NULL, 0, 0, NULL, NULL, 1, xt, xcnt, xr));
+}
+
+/**
+ * @fn adaptive_ms_intl
+ *
+ * @brief the default adaptive band under up to G schemes at once. Each scheme takes
+ * a group of C = LEN / G lanes, and cell l of scheme g sits in lane g * C + l / (bw / C)
+ * of block l % (bw / C) + 1. Each scheme steers, rebases, and ends on its own.
+ *
+ * Blocks 0 and bw / C + 1 pass the cells from one lane of a group to the next, and
+ * hold the pads at the ends of the group. Groups past scnt or already ended keep
+ * running, but their results are not read. bw must be a multiple of C.
+ */
+template<typename T, uint64_t G>
+static inline
+void adaptive_ms_intl(
+	void *work,
+	char const *a, uint64_t alen,
+	char const *b, uint64_t blen,
+	scheme_t const *sc, uint64_t scnt, uint32_t bw,
+	xdrop_result_t *r)
+{
+	typedef vec_t<T> vec;
+	typedef char_vec_t<T> char_vec;
+	uint64_t const L = vec::LEN, C = L / G, nblk = bw / C;
+
+	if(alen == 0 || blen == 0) {
+		for(uint64_t k = 0; k < scnt; k++) { r[k] = (xdrop_result_t){ 0, 0, 0 }; }
+		return;
+	}
+
+	/* per-lane scalars and their vectors, gi fixed with ge; the groups past scnt take the first scheme.
+	   f* and l* mark the first and the last lanes of each group, e* the lanes of the center cell */
+	int64_t gi[L], ge[L], sc_max[L], sc_min[L], rbase[L];
+	uint64_t apos[L], bpos[L];
+	uint16_t tgi[L] __attribute__(( aligned(ARENA_ALIGN) )), tge[L] __attribute__(( aligned(ARENA_ALIGN) ));
+	uint16_t tm[L] __attribute__(( aligned(ARENA_ALIGN) )), tx[L] __attribute__(( aligned(ARENA_ALIGN) ));
+	uint16_t txt[L] __attribute__(( aligned(ARENA_ALIGN) )), td[L] __attribute__(( aligned(ARENA_ALIGN) ));
+	uint16_t tpv[L] __attribute__(( aligned(ARENA_ALIGN) )), tf[L] __attribute__(( aligned(ARENA_ALIGN) ));
+	uint16_t tl[L] __attribute__(( aligned(ARENA_ALIGN) ));
+	int8_t ca[L], cb[L], dc[L], nf[L], nl[L];
+	int64_t sc_top = 1;
+	uint64_t fbits = 0, ebits = 0;
+	for(uint64_t k = 0; k < L; k++) {
+		scheme_t const &s = sc[k / C < scnt ? k / C : 0];
+		gi[k] = s.gi + s.ge; ge[k] = s.ge;
+		sc_max[k] = MAX2(s.m, s.x); sc_min[k] = MIN2(s.m, s.x);
+		sc_top = MAX2(sc_top, sc_max[k]);
+		tgi[k] = -gi[k]; tge[k] = -ge[k]; tm[k] = s.m; tx[k] = s.x; txt[k] = s.xt; tpv[k] = -sc_min[k];
+		tf[k] = k % C == 0 ? 0xffff : 0; tl[k] = k % C == C - 1 ? 0xffff : 0;
+		nf[k] = ~tf[k]; nl[k] = ~tl[k];
+		ca[k] = cb[k] = 0;
+		fbits |= (uint64_t)(k % C == 0)<<(2 * k);
+		ebits |= (uint64_t)(k % C == (bw / 2) / nblk)<<(2 * k);
+		apos[k] = bpos[k] = bw / 2; rbase[k] = 0;
+	}
+	vec const giv(tgi), gev(tge), mv(tm), xv(tx), xtv(txt), zv((uint16_t)0);
+	vec const pvv(tpv), fmv(tf), lmv(tl);
+	char_vec const cnf(nf), cnl(nl), czv((int8_t)0);
+
+	/* the 16-entry matrix split into the matches and all the entries, giving zero on the pads */
+	int8_t mt[16] __attribute__(( aligned(16) )), nt[16] __attribute__(( aligned(16) ));
+	for(uint64_t i = 0; i < 16; i++) { mt[i] = (i & 0x03) == (i>>2) ? -1 : 0; nt[i] = -1; }
+	vec const mtv = vec::table(mt), ntv = vec::table(nt);
+
+	/* init, as band_init and the first chars of adaptive_affine_intl on each group */
+	typedef band_s<vec::LEN, LAYOUT_AOS> band;
+	band const w((uint8_t *)work + arena_roundup(sizeof(maxpos_t)), nblk + 2);
+	#define _Q(x)		( (int64_t)(x) - (int64_t)bw / 2 )
+	for(uint64_t k = 0; k < L; k++) {
+		for(uint64_t j = 0; j < nblk + 2; j += nblk + 1) {
+			w[j].a[k] = w[j].b[k] = 0;
+			w[j].pv[k] = -sc_min[k]; w[j].cv[k] = -gi[k];
+			w[j].ce[k] = w[j].cf[k] = -ge[k];
+		}
+		for(uint64_t j = 0; j < nblk; j++) {
+			uint64_t const i = (k % C) * nblk + j;
+			int64_t const d = 2 * gi[k] - sc_max[k];
+			w[j + 1].a[k] = i < bw / 2 ? (bw / 2 - 1 - i < alen ? encode_a(a[bw / 2 - 1 - i]) : encode_n()) : 0x80;
+			w[j + 1].b[k] = i < bw / 2 ? 0xff : (i - bw / 2 < blen ? encode_b(b[i - bw / 2]) : encode_n());
+			w[j + 1].pv[k] = (_Q(i) < 0 ? -_Q(i) : _Q(i)) * d + OFS;
+			w[j + 1].cv[k] = gi[k] + (_Q(i) < 0 ? -_Q(i)-1 : _Q(i)) * d + OFS;
+			w[j + 1].ce[k] = gi[k] + (_Q(i) < 0 ? -_Q(i)-1 : _Q(i) + 1) * d + OFS;
+			w[j + 1].cf[k] = gi[k] + (_Q(i) < 0 ? -_Q(i) : _Q(i)) * d + OFS;
+		}
+	}
+	#undef _Q
+
+	/* the max over the band (all the cells so far) and the one of its center cell, as the max
+	   of the lanes of adaptive_affine_intl; the result of scheme g at the vector it ended on */
+	vec gmax((uint16_t)MIN), cmax((uint16_t)MIN);
+	#define _result(_g) { \
+		gmax.store(td); \
+		uint16_t _m = 0; \
+		for(uint64_t _c = 0; _c < C; _c++) { _m = MAX2(_m, td[(_g) * C + _c]); } \
+		r[_g] = (xdrop_result_t){ (int64_t)_m - OFS + rbase[_g], apos[_g] - bw / 2, bpos[_g] - bw / 2 + 1 }; \
+	}
+
+	/* the first (bw - 1) and the last (0) cells at the first lane of each group, the
+	   direction spread to the rest of it; lane k in bits 2k and 2k + 1 of the masks */
+	#define _dir(_fld) ({ \
+		vec const _lo(w[1]._fld), _up = vec(w[nblk]._fld) >> (C - 1); \
+		vec _d = fmv & vec::comp(vec::comp(vec::max(_up, _lo), _lo), zv); \
+		for(uint64_t _s = 1; _s < C; _s <<= 1) { _d = _d | (_d << _s); } \
+		_d; \
+	})
+
+	/* the previous direction as the first one of adaptive_affine_intl */
+	uint64_t live = vec::MASK>>(2 * (L - scnt * C));
+	vec pdv = _dir(pv);
+
+	uint64_t const rspan = MAX2(1, REBASE_SPAN / sc_top);
+	uint64_t rcnt = rspan;
+	for(uint64_t p = 0; p < (uint64_t)(alen+blen-1) && live != 0; p++) {
+		if(--rcnt == 0) {
+			/* the groups over REBASE_THRESH brought back to OFS, the others by zero */
+			rcnt = rspan;
+			uint64_t over = 0;
+			gmax.store(td);
+			for(uint64_t g = 0; g < G; g++) {
+				uint16_t m = 0;
+				for(uint64_t c = 0; c < C; c++) { m = MAX2(m, td[g * C + c]); }
+				uint16_t const d = m > REBASE_THRESH ? m - OFS : 0;
+				for(uint64_t c = 0; c < C; c++) { td[g * C + c] = d; }
+				rbase[g] += d; over |= d;
+			}
+			if(over != 0) {
+				vec const dv(td);
+				for(uint64_t i = 1; i <= nblk; i++) {
+					(vec(w[i].pv) - dv).store(w[i].pv); (vec(w[i].cv) - dv).store(w[i].cv);
+					(vec(w[i].ce) - dv).store(w[i].ce); (vec(w[i].cf) - dv).store(w[i].cf);
+				}
+				gmax = gmax - dv; cmax = cmax - dv;
+			}
+		}
+
+		/* STEER_EDGE on each group: down where the upper (b) edge is above the lower (a) one */
+		vec const dv = _dir(cv);
+		vec const ddv = dv & pdv, rrv = vec::comp(dv | pdv, zv);
+		uint64_t const dm = dv.mask();
+		for(uint64_t m = live & fbits; m != 0; m &= m - 1) {
+			uint64_t const k = tzcnt(m) / 2, g = k / C, d = (dm>>(2 * k)) & 0x01;
+			memset(&dc[k], -d, C);
+			ca[k] = apos[g] < alen ? encode_a(a[apos[g]]) : encode_n();
+			cb[k + C - 1] = bpos[g] < blen ? encode_b(b[bpos[g]]) : encode_n();
+			bpos[g] += d; apos[g] += 1 - d;
+		}
+		pdv = dv;
+
+		/* cell l from l (the same cell), l + 1 (down), or l - 1 (right) of each lane; p*: the previous block
+		   before update, t*: the current one, n*: the next one, carried over to the next cell. The ones before
+		   block 1 and after block bw / C from the lane below and above, or the new chars and the pads */
+		char_vec const dcv(dc), rcv = dcv ^ char_vec((int8_t)-1);
+		char_vec pa = (char_vec(w[nblk].a).dsl(czv) & cnf) | char_vec(ca), tb(w[1].b);
+		((czv.dsr(char_vec(w[1].b)) & cnl) | char_vec(cb)).store(w[nblk + 1].b);
+		lmv.select(pvv, vec(w[1].pv) >> 1).store(w[nblk + 1].pv);
+		lmv.select(giv, vec(w[1].cv) >> 1).store(w[nblk + 1].cv);
+		lmv.select(gev, vec(w[1].ce) >> 1).store(w[nblk + 1].ce);
+		vec pp = fmv.select(pvv, vec(w[nblk].pv) << 1), pc = fmv.select(giv, vec(w[nblk].cv) << 1);
+		vec pf = fmv.select(gev, vec(w[nblk].cf) << 1);
+		vec tp(w[1].pv), tc(w[1].cv), te(w[1].ce);
+		for(uint64_t i = 1; i <= nblk; i++) {
+			char_vec const ta(w[i].a), nb(w[i + 1].b);
+			char_vec const va = (ta & dcv) | (pa & rcv), vb = (nb & dcv) | (tb & rcv);
+			pa = ta; tb = nb;
+			va.store(w[i].a); vb.store(w[i].b);
+
+			/* m or x of each lane */
+			char_vec const c = va | vb;
+			vec const scv = mtv.shuffle(c).select(mv, ntv.shuffle(c) & xv);
+
+			vec const tf(w[i].cf), np(w[i + 1].pv), nc(w[i + 1].cv), ne(w[i + 1].ce);
+			vec const vd = ddv.select(np, rrv.select(pp, tp));
+			vec const vh = dv.select(nc, tc), vv = dv.select(tc, pc);
+			vec const ve = dv.select(ne, te), vf = dv.select(tf, pf);
+
+			vec const ue = vec::max(vh - giv, ve - gev);
+			vec const uf = vec::max(vv - giv, vf - gev);
+			vec const uv = vec::max(vec::max(ue, uf), vd + scv);
+			tc.store(w[i].pv); uv.store(w[i].cv);
+			ue.store(w[i].ce); uf.store(w[i].cf);
+			gmax = vec::max(gmax, uv);
+			pp = tp; pc = tc; pf = tf;
+			tp = np; tc = nc; te = ne;
+		}
+
+		/* X-drop on the center cell of each group */
+		vec const cc(w[(bw / 2) % nblk + 1].cv);
+		cmax = vec::max(cmax, cc);
+		uint64_t const drop = (cc < cmax - xtv) & live & ebits;
+		for(uint64_t m = drop & 0x5555555555555555; m != 0; m &= m - 1) {
+			uint64_t const g = tzcnt(m) / 2 / C;
+			_result(g);
+			live &= ~((~0ULL>>(64 - 2 * C))<<(2 * g * C));
+		}
+	}
+	for(uint64_t m = live & fbits; m != 0; m &= m - 1) {
+		uint64_t const g = tzcnt(m) / 2 / C;
+		_result(g);
+	}
+	#undef _dir
+	#undef _result
+}
+
+/**
+ * @fn adaptive_ms
+ *
+ * @brief adaptive_affine under each of the scnt schemes of sc, with m and x on the
+ * 16-entry matrix. The score and the center cell each scheme ended on go to r[k], the
+ * same as running the scheme alone. Returns the score of the first scheme.
+ *
+ * The schemes run in passes of a power of two at a time, with more lanes per scheme
+ * when bw is not a multiple of the group. bw may be any even width. The work holds
+ * the band after maxpos_t, bw + 2 blocks at the most.
+ */
+int
+_isa(adaptive_ms)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	scheme_t const *sc, uint64_t scnt, uint32_t bw,
+	xdrop_result_t *r)
+{
+	static uint64_t const L = vec_t<isa_t>::LEN;
+	for(uint64_t k = 0; k < scnt;) {
+		uint64_t g = L;
+		while(g > 1 && g > scnt - k) { g >>= 1; }
+		while(bw % (L / g) != 0) { g <<= 1; }
+		uint64_t const n = MIN2(g, scnt - k);
+
+		/* G as a constant, up to the lanes of the vector */
+		#define _ms(_g)		adaptive_ms_intl<isa_t, MIN2(_g, L)>(work, a, alen, b, blen, &sc[k], n, bw, &r[k])
+		switch(g) {
+			case 1: _ms(1); break;
+			case 2: _ms(2); break;
+			case 4: _ms(4); break;
+			case 8: _ms(8); break;
+			case 16: _ms(16); break;
+			default: _ms(32); break;
+		}
+		#undef _ms
+		k += n;
+	}
+	return(scnt == 0 ? 0 : r[0].score);
+}
+
+/**
+ * @fn adaptive_linear
+ *
+ * @brief linear gap (ge per base, gi ignored); no e and f state
+ */
+int
+_isa(adaptive_linear)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_LINEAR, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_dual
+ *
+ * @brief dual affine gap: the better of (gi, ge) and (gi2, ge2) per gap
+ */
+int
+_isa(adaptive_dual)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int8_t gi2, int8_t ge2, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_DUAL, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw, NULL, gi2, ge2));
+}
+
+/**
+ * @fn adaptive_protein
+ *
+ * @brief affine gap on protein (or any alphabet of aa_matrix_t, see build_aa_matrix
+ * in util.h)
+ */
+int
+_isa(adaptive_protein)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	aa_matrix_t const *aa, int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, aa_view(a, alen, aa), aa_view(b, blen, aa), (int8_t *)aa->score, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_qv
+ *
+ * @brief quality-aware scoring: the table of qv (util.h) picked by the quality
+ * in qa of each base of a
+ */
+int
+_isa(adaptive_qv)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	qv_matrix_t const *qv, uint8_t const *qa, int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, qv_view(a, qa, alen, qv), fw_view(b, blen), (int8_t *)qv->score[0], gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_local
+ *
+ * @brief local (Smith-Waterman): the cells floored at zero, so that the alignment
+ * may start anywhere in the band; the X-drop still ends it
+ */
+int
+_isa(adaptive_local)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_LOCAL>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_endfree
+ *
+ * @brief end-free extension: anchored at (0, 0) as adaptive_affine, the best cell on
+ * the last row or column (the end of a or of b reached); the start is not free
+ */
+int
+_isa(adaptive_endfree)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_ENDFREE>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_global
+ *
+ * @brief global (end-to-end) alignment for filling the gap between two anchors:
+ * the band steered to end on (alen, blen), the score of that cell returned; no X-drop
+ */
+int
+_isa(adaptive_global)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_GLOBAL>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_global_path
+ *
+ * @brief adaptive_global with the path (M, X, I, D as sw_affine) written to path,
+ * which takes alen + blen + 1 chars; the path is left empty if it could not be traced
+ */
+int
+_isa(adaptive_global_path)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, uint32_t bw, char *path)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_GLOBAL>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, 0, bw, NULL, 0, 0, path));
+}
+
+/**
+ * @fn chain_exact
+ *
+ * @brief the last stage of the chain on small pairs: the extension score of the
+ * full dp (sw_affine in full.c), row by row over two rows of blen + 1 cells at h and
+ * f, with no path. The max cell is left in r.
+ */
+static inline
+int chain_exact(int16_t *h, int16_t *f, maxpos_t *r, char const *a, uint64_t alen, char const *b, uint64_t blen, int8_t *score_matrix, int8_t gi, int8_t ge)
+{
+	int16_t const min = INT16_MIN - extract_min_score(score_matrix) - gi;
+	int32_t const go = gi + ge;
+
+	/* the first row and column by the init of full.c */
+	h[0] = f[0] = 0;
+	for(uint64_t j = 1; j < blen + 1; j++) {
+		h[j] = MAX2(min, go + (int32_t)(j - 1) * ge);
+		f[j] = MAX2(min, go + (int32_t)(j - 1) * ge + gi - 1);
+	}
+
+	int32_t max = 0;
+	uint64_t apos = 0, bpos = 0;
+	for(uint64_t i = 1; i < alen + 1; i++) {
+		int16_t diag = h[0];
+		h[0] = f[0] = MAX2(min, go + (int32_t)(i - 1) * ge);
+		int16_t e = MAX2(min, go + (int32_t)(i - 1) * ge + gi - 1);
+		for(uint64_t j = 1; j < blen + 1; j++) {
+			f[j] = MAX2(h[j] + go, f[j] + ge);
+			e = MAX2(h[j - 1] + go, e + ge);
+			int16_t const score = MAX4(min, diag + score_matrix[encode_a(a[i - 1]) | encode_b(b[j - 1])], f[j], e);
+			diag = h[j];
+			h[j] = score;
+			if(score > max) { max = score; apos = i; bpos = j; }
+		}
+	}
+	r->apos = apos;
+	r->bpos = bpos;
+	return(max);
+}
+
+/**
+ * @fn adaptive_chain_affine
+ *
+ * @brief reruns the pair on band loss: adaptive at bw, at CHAIN_WIDEN * bw, then
+ * simdblast, or the full dp instead for pairs up to CHAIN_EXACT_CELLS. the stage
+ * it ended at is left in the maxpos_t at the head of the work.
+ */
+int _isa(simdblast_affine)(void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw);
+
+int
+_isa(adaptive_chain_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	maxpos_t *r = (maxpos_t *)work;
+	uint32_t loss = 0;
+
+	/* the scores are lower bounds of the full dp; the stages only raise it */
+	int score = adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw, &loss);
+	if(loss == 0) { r->stage = CHAIN_NARROW; return(score); }
+
+	int wide = adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, MIN2(CHAIN_WIDEN * bw, BW_MAX), &loss);
+	score = MAX2(score, wide);
+	if(loss == 0) { r->stage = CHAIN_WIDE; return(score); }
+
+	if(alen * blen <= CHAIN_EXACT_CELLS) {
+		/* the two rows after maxpos_t, in the arena the banded stages used */
+		int16_t *h = (int16_t *)((uint8_t *)work + arena_roundup(sizeof(maxpos_t)));
+		int16_t *f = h + blen + 1;
+		int const exact = chain_exact(h, f, r, a, alen, b, blen, score_matrix, gi, ge);
+		r->stage = CHAIN_EXACT;
+		return(MAX2(score, exact));
+	}
+	int blast = _isa(simdblast_affine)(work, a, alen, b, blen, score_matrix, gi, ge, xt, bw);
+	r->stage = CHAIN_SIMDBLAST;
+	return(MAX2(score, blast));
+}
+
+/**
+ * @fn adaptive_blend_affine
+ *
+ * @brief branch-free direction selection (blend on the direction mask)
+ */
+int
+_isa(adaptive_blend_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BLEND, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_ident_affine
+ *
+ * @brief the default (branching) band with the path counters: the max cell and the
+ * matches, aligned columns, and gap opens on the path to it in the maxpos_t at the
+ * head of the work, for filtering on identity without a traceback
+ */
+int
+_isa(adaptive_ident_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND, COUNT_PATH>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_edgemax_affine
+ *
+ * @brief steers on the max of the outermost lanes of each edge
+ */
+int
+_isa(adaptive_edgemax_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGEMAX, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_gapsteer_affine
+ *
+ * @brief steers on the edge cells with the outward gaps counted in
+ */
+int
+_isa(adaptive_gapsteer_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_GAP, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_argmax_affine
+ *
+ * @brief steers the max lane toward the center
+ */
+int
+_isa(adaptive_argmax_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_ARGMAX, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_hyst_affine
+ *
+ * @brief steers with hysteresis
+ */
+int
+_isa(adaptive_hyst_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_HYST, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_widen_affine
+ *
+ * @brief widens the band while the max drops behind, up to WIDEN_MAX * bw
+ */
+int
+_isa(adaptive_widen_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_DYNAMIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_soa_affine
+ *
+ * @brief the band state in a plane per field
+ */
+int
+_isa(adaptive_soa_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_SOA, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_hybrid_affine
+ *
+ * @brief the chars apart from the scores
+ */
+int
+_isa(adaptive_hybrid_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_HYBRID, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_xband_affine
+ *
+ * @brief terminates when the whole vector falls xt below the max
+ */
+int
+_isa(adaptive_xband_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_BAND, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_zdrop_affine
+ *
+ * @brief Z-drop termination, xt is taken as the Z threshold
+ */
+int
+_isa(adaptive_zdrop_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, ZDROP, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_rv_affine
+ *
+ * @brief extends leftward from the tails of a and b
+ */
+int
+_isa(adaptive_rv_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, rv_view(a, alen), rv_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_rc_affine
+ *
+ * @brief aligns a to the reverse complement of b
+ */
+int
+_isa(adaptive_rc_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, fw_view(a, alen), rc_view(b, blen), score_matrix, gi, ge, xt, bw));
+}
+
+/**
+ * @fn adaptive_pk_affine
+ *
+ * @brief a and b are 2-bit packed arrays (4 bases per byte, LSb first)
+ */
+int
+_isa(adaptive_pk_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(adaptive_affine_intl<isa_t, XDROP_CENTER, DIR_BRANCH, STEER_EDGE, BAND_STATIC, LAYOUT_AOS, 0, GAP_AFFINE, ALIGN_EXTEND>(work, pk_view(a, alen), pk_view(b, blen), score_matrix, gi, ge, xt, bw));
 }
 
 #ifdef MAIN
@@ -313,7 +2137,7 @@ int main_ext(int argc, char *argv[])
 	if(0) {
 		printf("./a.out AAA AAA 2 -3 -5 -1 30\n");
 	}
-	int score = adaptive_affine(
+	int score = _isa(adaptive_affine)(
 		work,
 		a, alen, b, blen,
 		score_matrix,
@@ -340,7 +2164,7 @@ int main(int argc, char *argv[])
 	void *work = aligned_malloc(128 * 1024 * 1024, 16);
 
 	#define a(s, p, q) { \
-		assert(adaptive_affine(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10) == (s)); \
+		assert(_isa(adaptive_affine)(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10) == (s)); \
 	}
 	a( 0, "", "");
 	a( 0, "A", "");
@@ -352,7 +2176,7 @@ int main(int argc, char *argv[])
 	a( 4, "AAACAAAGGG", "AAAAAATTTTTTT");
 	a( 3, "AAACCAAAGGG", "AAAAAATTTTTTT");
 
-	int sa = adaptive_affine(work, a, strlen(a), b, strlen(b), score_matrix, -1, -1, 30);
+	int sa = _isa(adaptive_affine)(work, a, strlen(a), b, strlen(b), score_matrix, -1, -1, 30);
 	printf("%d\n", sa);
 
 
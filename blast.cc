@@ -11,24 +11,31 @@
 #define MIN			( -32768 + 30 )
 
 /**
- * @fn blast_affine
+ * @fn blast_affine_intl
+ *
+ * @brief given xs, the xcnt - 1 thresholds below _xt (sorted) are recorded to xr as
+ * they fall: at the first row without a cell within xs[k] of the best so far
  */
+static inline
 int
-blast_affine(
+blast_affine_intl(
 	void *work,
 	char const *a,
 	uint64_t alen,
 	char const *b,
 	uint64_t blen,
 	int8_t *score_matrix, int8_t _gi, int8_t _ge, int16_t _xt,
-	uint32_t bw)		/* unused */
+	int16_t const *xs = NULL, uint64_t xcnt = 0, xdrop_result_t *xr = NULL)
 {
-	if(alen == 0 || blen == 0) { return(0); }
+	if(alen == 0 || blen == 0) {
+		for(uint64_t k = 0; k < xcnt; k++) { xr[k] = (xdrop_result_t){ 0, 0, 0 }; }
+		return(0);
+	}
 	debug("%s, %s", a, b);
 
 	int32_t gi = _gi, ge = _ge, xt = _xt, best_score = 0;
 	uint64_t first_b_index = 0, last_b_index = blen + 1;		/* [first_b_index, last_b_index) */
-	uint64_t amax = 0, bmax = 0;
+	uint64_t amax = 0, bmax = 0, xk = 0;
 
 	struct _dp { int16_t s, e, f; };
 	struct _dp *ptr = (struct _dp *)work + sizeof(maxpos_t), *prev;
@@ -57,13 +64,15 @@ blast_affine(
 		int32_t f = MIN;
 		int32_t s = e;
 		debug("initial, b_index(%llu), score(%d, %d, %d)", first_b_index, s, e, f);
-		while(s < best_score - xt) {
+		/* not past the last cell of prev, whose next holds the best score, not a cell */
+		while(s < best_score - xt && first_b_index + 1 < last_b_index) {
 			e = MAX2(prev[first_b_index + 1].e, prev[first_b_index + 1].s + gi) + ge;
 			f = MAX2(f, s + gi) + ge;
 			s = MAX3(prev[first_b_index].s + _sc(ach, first_b_index), e, f);
 			first_b_index++; ptr--;
 			debug("forward head, b_index(%llu), ch(%x), score(%d, %d, %d)", first_b_index, encode_b(b[first_b_index]) | ach, s, e, f);
 		}
+		uint64_t const dead = s < best_score - xt;		/* left to the tail */
 
 		debug("ptr(%p, %p), b_range(%llu, %llu)", prev, ptr, first_b_index, last_b_index);
 		ptr[first_b_index].s = s;
@@ -71,10 +80,12 @@ blast_affine(
 		ptr[first_b_index].f = f;
 
 		uint64_t next_last_b_index = last_b_index;
+		int32_t rmax = s;
 		for(uint64_t b_index = first_b_index + 1; b_index < last_b_index; b_index++) {
 			e = MAX2(prev[b_index].e, prev[b_index].s + gi) + ge;
 			f = MAX2(f, s + gi) + ge;
 			s = MAX3(prev[b_index - 1].s + _sc(ach, b_index - 1), e, f);
+			rmax = MAX2(rmax, s);
 			if(s > best_score) { best_score = s; amax = a_index + 1; bmax = b_index; }
 			if(s >= best_score - xt) { next_last_b_index = b_index + 1; }
 
@@ -85,6 +96,7 @@ blast_affine(
 		}
 		last_b_index = next_last_b_index;
 
+		uint64_t const tail_b_index = last_b_index;
 		if(last_b_index <= blen) {
 			int32_t d = prev[last_b_index - 1].s + _sc(ach, last_b_index - 1);
 			debug("tail, b_index(%llu, %p, %p), ch(%x), d(%d, %d)", last_b_index, &ptr[last_b_index].s, &prev[last_b_index].s, encode_b(b[last_b_index - 1]) | ach, prev[last_b_index - 1].s, d);
@@ -97,6 +109,7 @@ blast_affine(
 				if(s < best_score - xt) { debug("xdrop failed, s(%d, %d)", s, best_score - xt); break; }
 
 				d = MIN;
+				rmax = MAX2(rmax, s);
 				ptr[last_b_index].s = s;
 				ptr[last_b_index].e = e;
 				ptr[last_b_index].f = f;
@@ -104,10 +117,21 @@ blast_affine(
 				debug("forward tail, a_index(%llu, %p), score(%d, %d, %d)", last_b_index, &ptr[last_b_index - 1].s, s, e, f);
 			}
 		}
+		if(dead && last_b_index == tail_b_index) {
+			/* no cell left within xt of the best */
+			debug("xdrop, a_index(%llu)", a_index);
+			break;
+		}
 		ptr[last_b_index].s = best_score;
 		ptr[last_b_index].e = last_b_index - first_b_index;
 		ptr[last_b_index].f = first_b_index;
+
+		while(xk + 1 < xcnt && rmax < best_score - xs[xk]) {
+			xr[xk++] = (xdrop_result_t){ best_score, amax, bmax };
+		}
 	}
+	while(xk < xcnt) { xr[xk++] = (xdrop_result_t){ best_score, amax, bmax }; }
+
 	/* save the maxpos */
 	maxpos_t *r = (maxpos_t *)work;
 	r->alen = alen;
@@ -117,6 +141,44 @@ blast_affine(
 	return(best_score);
 }
 
+/**
+ * @fn blast_affine
+ */
+int
+blast_affine(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(blast_affine_intl(work, a, alen, b, blen, score_matrix, gi, ge, xt));
+}
+
+/**
+ * @fn blast_mx
+ *
+ * @brief the results at each of the xcnt thresholds of xt (sorted ascending) in a
+ * single pass at the largest, to xr. X also prunes the cells here, so the smaller
+ * ones end on the band the largest keeps (see blast_affine_intl), not on their own;
+ * they differ from a run at them alone where their pruning would have lost the path.
+ */
+int
+blast_mx(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t const *xt, uint64_t xcnt,
+	uint32_t bw,		/* unused */
+	xdrop_result_t *xr)
+{
+	return(blast_affine_intl(work, a, alen, b, blen, score_matrix, gi, ge, xt[xcnt - 1], xt, xcnt, xr));
+}
+
 #ifdef MAIN
 #include <assert.h>
 #include <stdlib.h>
@@ -5,6 +5,7 @@
  * @brief diagonal parallelization of the standard banded matrix
  */
 #include <string.h>
+#include "isa.h"
 #include "sse.h"
 #include "util.h"
 
@@ -12,10 +13,12 @@
 #define OFS 	( 32768 )
 
 /**
- * @fn diagonal_affine
+ * @fn diagonal_affine_intl
  */
+template<typename T>
+static inline
 int
-diagonal_affine(
+diagonal_affine_intl(
 	void *work,
 	char const *a,
 	uint64_t alen,
@@ -23,6 +26,9 @@ diagonal_affine(
 	uint64_t blen,
 	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
 {
+	typedef vec_t<T> vec;
+	typedef char_vec_t<T> char_vec;
+
 	if(alen == 0 || blen == 0) { return(0); }
 	debug("%s, %s", a, b);
 
@@ -31,10 +37,12 @@ diagonal_affine(
 	#define _e(_p, _i)		( (_p)[    bw + (_i)] )
 	#define _f(_p, _i)		( (_p)[2 * bw + (_i)] )
 	#define _vlen()			( 3 * bw )
-	uint8_t abuf[bw + vec::LEN], bbuf[bw + vec::LEN];
+
+	/* char buffers after maxpos_t, the vectors from the next cache line (see util.h) */
+	uint8_t *abuf = (uint8_t *)work + sizeof(maxpos_t), *bbuf = abuf + bw + vec::LEN;
 
 	/* init the leftmost vector (vertically placed) */
-	uint16_t *base = (uint16_t *)((uint8_t *)work + sizeof(maxpos_t));
+	uint16_t *base = (uint16_t *)((uint8_t *)work + arena_roundup(sizeof(maxpos_t) + 2 * (bw + vec::LEN)));
 	uint16_t *curr = base + _vlen();
 	int8_t max_match = extract_max_score(score_matrix);
 	#define _gap(_i)		( ((_i) > 0 ? gi : 0) + (_i) * ge )
@@ -64,9 +72,10 @@ diagonal_affine(
 		bbuf[bw/2     + i] = i < blen ? encode_b(b[i]) : encode_n();
 	}
 	uint64_t smax = OFS, pmax = 0;				/* max score and its position */
+	uint64_t cmax = OFS, pcnt = alen + blen - 1;	/* max of the center cells, #vectors calculated */
 
 	char_vec const cz;							/* zero */
-	vec const z, giv(-gi), gev(-ge), smv((uint16_t const *)score_matrix);
+	vec const z, giv(-gi), gev(-ge), smv(vec::table(score_matrix));
 	vec max(OFS);
 	for(uint64_t p = 2; p < alen + blen + 1; p++) {
 		curr += _vlen();
@@ -155,6 +164,11 @@ diagonal_affine(
 		uint16_t m = max.hmax();
 		debug("m(%u), pm(%llu)", m, smax);
 		if(m > smax) { smax = m; pmax = p; }
+
+		/* X-drop test on the center cell, the same as the adaptive band */
+		uint64_t c = _s(curr, bw / 2);
+		cmax = MAX2(cmax, c);
+		if(c + xt < cmax) { debug("xdrop"); pcnt = p - 1; break; }
 	}
 
 	/* save the maxpos */
@@ -162,7 +176,7 @@ diagonal_affine(
 	r->alen = alen;
 	r->blen = blen;
 	#ifdef debug
-		r->ccnt = bw * (alen + blen - 1);
+		r->ccnt = bw * pcnt;
 		r->fcnt = 0;
 	#endif
 
@@ -184,6 +198,21 @@ diagonal_affine(
 	return(m - OFS);
 }
 
+/**
+ * @fn diagonal_affine
+ */
+int
+_isa(diagonal_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(diagonal_affine_intl<isa_t>(work, a, alen, b, blen, score_matrix, gi, ge, xt, bw));
+}
+
 #ifdef MAIN
 #include <assert.h>
 #include <stdlib.h>
@@ -208,7 +237,7 @@ int main_ext(int argc, char *argv[])
 	if(0) {
 		printf("./a.out AAA AAA 2 -3 -5 -1 30\n");
 	}
-	int score = diagonal_affine(
+	int score = _isa(diagonal_affine)(
 		work,
 		a, alen, b, blen,
 		score_matrix,
@@ -236,7 +265,7 @@ int main(int argc, char *argv[])
 	void *work = aligned_malloc(128 * 1024 * 1024, 16);
 
 	#define a(s, p, q) { \
-		assert(diagonal_affine(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10, 32) == (s)); \
+		assert(_isa(diagonal_affine)(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10, 32) == (s)); \
 	}
 	a( 0, "", "");
 	a( 0, "A", "");
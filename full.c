@@ -15,23 +15,111 @@
 typedef struct { int64_t score; uint64_t apos, bpos; } sw_maxpos_t;
 
 /**
- * @fn sw_affine
+ * @fn sw_linear
  */
-sw_result_t sw_affine(
+sw_result_t sw_linear(
 	char const *a,
 	uint64_t alen,
 	char const *b,
 	uint64_t blen,
-	int8_t *score_matrix, int8_t gi, int8_t ge)
+	int8_t *score_matrix, int8_t ge)
+{
+	/* utils */
+	#define a(p, q)		_a(p, q, alen)
+	#define s(p, q)		( score_matrix[encode_a(a[(p) - 1]) | encode_b(b[(q) - 1])] )
+
+	int16_t const min = INT16_MIN - extract_min_score(score_matrix) - ge;
+
+	int16_t *mat = (int16_t *)malloc(
+		(alen + 1) * (blen + 1) * sizeof(int16_t));
+
+	/* init */
+	sw_maxpos_t max = { 0, 0, 0 };
+	mat[a(0, 0)] = 0;
+	for(uint64_t i = 1; i < alen+1; i++) {
+		mat[a(i, 0)] = MAX2(min, i * ge);
+	}
+	for(uint64_t j = 1; j < blen+1; j++) {
+		mat[a(0, j)] = MAX2(min, j * ge);
+	}
+
+	for(uint64_t i = 1; i < alen+1; i++) {
+		for(uint64_t j = 1; j < blen+1; j++) {
+			int16_t score = mat[a(i, j)] = MAX4(min,
+				mat[a(i - 1, j - 1)] + s(i, j),
+				mat[a(i - 1, j)] + ge,
+				mat[a(i, j - 1)] + ge);
+			if(score > max.score) { max = (sw_maxpos_t){ score, i, j }; }
+		}
+	}
+	if(max.score == 0) { max = (sw_maxpos_t){ 0, 0, 0 }; }
+
+	sw_result_t result;
+	result = (sw_result_t){
+		.score = max.score,
+		.apos = max.apos,
+		.bpos = max.bpos,
+		.path_length = max.apos + max.bpos + 1,
+		.path = (char *)malloc(max.apos + max.bpos + 1)
+	};
+	uint32_t path_index = max.apos + max.bpos + 1;
+	while(max.apos != 0 || max.bpos != 0) {
+		if(max.bpos > 0 && mat[a(max.apos, max.bpos)] == mat[a(max.apos, max.bpos - 1)] + ge) {
+			max.bpos--;
+			result.path[--path_index] = 'I';
+		} else if(max.apos > 0 && mat[a(max.apos, max.bpos)] == mat[a(max.apos - 1, max.bpos)] + ge) {
+			max.apos--;
+			result.path[--path_index] = 'D';
+		} else {
+			if(a[max.apos - 1] != b[max.bpos - 1]) {
+				result.path[--path_index] = 'X';
+			} else {
+				result.path[--path_index] = 'M';
+			}
+			max.apos--;
+			max.bpos--;
+		}
+	}
+
+	result.path_length -= path_index;
+	for(uint64_t i = 0; i < result.path_length; i++) {
+		result.path[i] = result.path[path_index++];
+	}
+	result.path[result.path_length] = '\0';
+
+	free(mat);
+
+	#undef a
+	#undef s
+	return(result);
+}
+
+/**
+ * @fn sw_affine_intl
+ *
+ * @brief scored with the 16-entry nucleotide matrix, with the table of aa if not NULL,
+ * or with the table of the quality bin of each base of a if qv is not NULL; mode is
+ * one of align_mode_e (util.h)
+ */
+static
+sw_result_t sw_affine_intl(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, aa_matrix_t const *aa, qv_matrix_t const *qv, uint8_t const *qa, int8_t gi, int8_t ge, int mode)
 {
 	/* utils */
 	#define a(p, q)		_a(p, 3*(q), alen)
 	#define f(p, q)		_a(p, 3*(q)+1, alen)
 	#define e(p, q)		_a(p, 3*(q)+2, alen)
 	// #define s(p, q)		( (a[(p) - 1] == b[(q) - 1]) ? m : x )
-	#define s(p, q)		( score_matrix[encode_a(a[(p) - 1]) | encode_b(b[(q) - 1])] )
+	#define _aa(_c)		( aa->map[(uint8_t)(_c)] & (AA_DIM - 1) )
+	#define s(p, q)		( aa != NULL ? aa->score[_aa(a[(p) - 1]) * AA_DIM + _aa(b[(q) - 1])] \
+		: (qv != NULL ? qv->score[qv->bin[qa[(p) - 1]]] : score_matrix)[encode_a(a[(p) - 1]) | encode_b(b[(q) - 1])] )
 
-	int16_t const min = INT16_MIN - extract_min_score(score_matrix) - gi;
+	int16_t const min = INT16_MIN - (aa != NULL ? aa->min : (qv != NULL ? qv->min : extract_min_score(score_matrix))) - gi;
+	int16_t const hmin = mode == ALIGN_LOCAL ? 0 : min;
 
 	int16_t *mat = (int16_t *)malloc(
 		3 * (alen + 1) * (blen + 1) * sizeof(int16_t));
@@ -45,10 +133,12 @@ sw_result_t sw_affine(
 	for(uint64_t i = 1; i < alen+1; i++) {
 		mat[a(i, 0)] = mat[f(i, 0)] = MAX2(min, gi + (i - 1) * ge);
 		mat[e(i, 0)] = MAX2(min, gi + (i - 1) * ge + gi - ge - 1);
+		if(mode == ALIGN_LOCAL) { mat[a(i, 0)] = 0; mat[f(i, 0)] = mat[e(i, 0)] = min; }
 	}
 	for(uint64_t j = 1; j < blen+1; j++) {
 		mat[a(0, j)] = mat[e(0, j)] = MAX2(min, gi + (j - 1) * ge);
 		mat[f(0, j)] = MAX2(min, gi + (j - 1) * ge + gi - ge - 1);
+		if(mode == ALIGN_LOCAL) { mat[a(0, j)] = 0; mat[e(0, j)] = mat[f(0, j)] = min; }
 	}
 
 	for(uint64_t i = 1; i < alen+1; i++) {
@@ -59,13 +149,15 @@ sw_result_t sw_affine(
 			int16_t score_e = mat[e(i, j)] = MAX2(
 				mat[a(i, j - 1)] + gi,
 				mat[e(i, j - 1)] + ge);
-			int16_t score = mat[a(i, j)] = MAX4(min,
+			int16_t score = mat[a(i, j)] = MAX4(hmin,
 				mat[a(i - 1, j - 1)] + s(i, j),
 				score_f, score_e);
+			if(mode == ALIGN_ENDFREE && i != alen && j != blen) { continue; }
 			if(score > max.score) { max = (sw_maxpos_t){ score, i, j }; }
 		}
 	}
 	if(max.score == 0) { max = (sw_maxpos_t){ 0, 0, 0 }; }
+	if(mode == ALIGN_GLOBAL) { max = (sw_maxpos_t){ mat[a(alen, blen)], alen, blen }; }
 
 	sw_result_t result;
 	result = (sw_result_t){
@@ -77,6 +169,14 @@ sw_result_t sw_affine(
 	};
 	uint32_t path_index = max.apos + max.bpos + 1;
 	while(max.apos != 0 || max.bpos != 0) {
+		/* global: along the edge to (0, 0) */
+		if(max.apos == 0 || max.bpos == 0) {
+			if(max.apos == 0) { max.bpos--; result.path[--path_index] = 'I'; }
+			else { max.apos--; result.path[--path_index] = 'D'; }
+			continue;
+		}
+		/* local: the alignment starts where the score rose from zero */
+		if(mode == ALIGN_LOCAL && mat[a(max.apos, max.bpos)] == 0) { break; }
 		if(mat[a(max.apos, max.bpos)] == mat[e(max.apos, max.bpos)]) {
 			while(mat[e(max.apos, max.bpos)] == mat[e(max.apos, max.bpos - 1)] + ge) {
 				max.bpos--;
@@ -115,9 +215,305 @@ sw_result_t sw_affine(
 	#undef f
 	#undef e
 	#undef s
+	#undef _aa
 	return(result);
 }
 
+/**
+ * @fn sw_affine
+ */
+sw_result_t sw_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge)
+{
+	return(sw_affine_intl(a, alen, b, blen, score_matrix, NULL, NULL, NULL, gi, ge, ALIGN_EXTEND));
+}
+
+/**
+ * @fn sw_local
+ *
+ * @brief Smith-Waterman local alignment, the reference of adaptive_local
+ */
+sw_result_t sw_local(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge)
+{
+	return(sw_affine_intl(a, alen, b, blen, score_matrix, NULL, NULL, NULL, gi, ge, ALIGN_LOCAL));
+}
+
+/**
+ * @fn sw_endfree
+ *
+ * @brief anchored at (0, 0), the best on the last row or column; the reference of adaptive_endfree
+ */
+sw_result_t sw_endfree(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge)
+{
+	return(sw_affine_intl(a, alen, b, blen, score_matrix, NULL, NULL, NULL, gi, ge, ALIGN_ENDFREE));
+}
+
+/**
+ * @fn sw_global
+ *
+ * @brief from (0, 0) to (alen, blen), the reference of adaptive_global
+ */
+sw_result_t sw_global(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge)
+{
+	return(sw_affine_intl(a, alen, b, blen, score_matrix, NULL, NULL, NULL, gi, ge, ALIGN_GLOBAL));
+}
+
+/**
+ * @fn sw_aa_affine
+ *
+ * @brief protein (any alphabet of aa_matrix_t), the reference of adaptive_protein
+ */
+sw_result_t sw_aa_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	aa_matrix_t const *aa, int8_t gi, int8_t ge)
+{
+	return(sw_affine_intl(a, alen, b, blen, NULL, aa, NULL, NULL, gi, ge, ALIGN_EXTEND));
+}
+
+/**
+ * @fn sw_qv_affine
+ *
+ * @brief quality-aware scoring (see qv_matrix_t) on the qualities qa of a, the reference of adaptive_qv and simdblast_qv
+ */
+sw_result_t sw_qv_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	qv_matrix_t const *qv, uint8_t const *qa, int8_t gi, int8_t ge)
+{
+	return(sw_affine_intl(a, alen, b, blen, NULL, NULL, qv, qa, gi, ge, ALIGN_EXTEND));
+}
+
+/**
+ * @fn sw_dual_affine
+ *
+ * @brief a gap of k costs the better of gi + k * ge and gi2 + k * ge2
+ */
+sw_result_t sw_dual_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int8_t gi2, int8_t ge2)
+{
+	/* utils */
+	#define a(p, q)		_a(p, 5*(q), alen)
+	#define f(p, q)		_a(p, 5*(q)+1, alen)
+	#define e(p, q)		_a(p, 5*(q)+2, alen)
+	#define f2(p, q)	_a(p, 5*(q)+3, alen)
+	#define e2(p, q)	_a(p, 5*(q)+4, alen)
+	#define s(p, q)		( score_matrix[encode_a(a[(p) - 1]) | encode_b(b[(q) - 1])] )
+
+	int16_t const min = INT16_MIN - extract_min_score(score_matrix) - MIN2(gi, gi2) - MIN2(ge, ge2);
+
+	int16_t *mat = (int16_t *)malloc(
+		5 * (alen + 1) * (blen + 1) * sizeof(int16_t));
+
+	/* fix gi */
+	gi += ge; gi2 += ge2;
+
+	/* init; the gaps along the edges take the better pair, the other direction closed */
+	sw_maxpos_t max = { 0, 0, 0 };
+	mat[a(0, 0)] = 0;
+	mat[f(0, 0)] = mat[e(0, 0)] = mat[f2(0, 0)] = mat[e2(0, 0)] = min;
+	for(uint64_t i = 1; i < alen+1; i++) {
+		mat[f(i, 0)] = MAX2(min, gi + (i - 1) * ge);
+		mat[f2(i, 0)] = MAX2(min, gi2 + (i - 1) * ge2);
+		mat[a(i, 0)] = MAX2(mat[f(i, 0)], mat[f2(i, 0)]);
+		mat[e(i, 0)] = mat[e2(i, 0)] = min;
+	}
+	for(uint64_t j = 1; j < blen+1; j++) {
+		mat[e(0, j)] = MAX2(min, gi + (j - 1) * ge);
+		mat[e2(0, j)] = MAX2(min, gi2 + (j - 1) * ge2);
+		mat[a(0, j)] = MAX2(mat[e(0, j)], mat[e2(0, j)]);
+		mat[f(0, j)] = mat[f2(0, j)] = min;
+	}
+
+	for(uint64_t i = 1; i < alen+1; i++) {
+		for(uint64_t j = 1; j < blen+1; j++) {
+			int16_t score_f = mat[f(i, j)] = MAX2(
+				mat[a(i - 1, j)] + gi,
+				mat[f(i - 1, j)] + ge);
+			int16_t score_e = mat[e(i, j)] = MAX2(
+				mat[a(i, j - 1)] + gi,
+				mat[e(i, j - 1)] + ge);
+			int16_t score_f2 = mat[f2(i, j)] = MAX2(
+				mat[a(i - 1, j)] + gi2,
+				mat[f2(i - 1, j)] + ge2);
+			int16_t score_e2 = mat[e2(i, j)] = MAX2(
+				mat[a(i, j - 1)] + gi2,
+				mat[e2(i, j - 1)] + ge2);
+			int16_t score = mat[a(i, j)] = MAX4(min,
+				mat[a(i - 1, j - 1)] + s(i, j),
+				MAX2(score_f, score_f2), MAX2(score_e, score_e2));
+			if(score > max.score) { max = (sw_maxpos_t){ score, i, j }; }
+		}
+	}
+	if(max.score == 0) { max = (sw_maxpos_t){ 0, 0, 0 }; }
+
+	sw_result_t result;
+	result = (sw_result_t){
+		.score = max.score,
+		.apos = max.apos,
+		.bpos = max.bpos,
+		.path_length = max.apos + max.bpos + 1,
+		.path = (char *)malloc(max.apos + max.bpos + 1)
+	};
+	uint32_t path_index = max.apos + max.bpos + 1;
+	#define _run(_m, _g, _d, _c) { \
+		while(_d > 0 && mat[_m(max.apos, max.bpos)] == mat[_m(max.apos - ((_c) == 'D'), max.bpos - ((_c) == 'I'))] + (_g)) { \
+			_d--; \
+			result.path[--path_index] = (_c); \
+		} \
+		_d--; \
+		result.path[--path_index] = (_c); \
+	}
+	while(max.apos != 0 || max.bpos != 0) {
+		if(mat[a(max.apos, max.bpos)] == mat[e(max.apos, max.bpos)]) {
+			_run(e, ge, max.bpos, 'I');
+		} else if(mat[a(max.apos, max.bpos)] == mat[e2(max.apos, max.bpos)]) {
+			_run(e2, ge2, max.bpos, 'I');
+		} else if(mat[a(max.apos, max.bpos)] == mat[f(max.apos, max.bpos)]) {
+			_run(f, ge, max.apos, 'D');
+		} else if(mat[a(max.apos, max.bpos)] == mat[f2(max.apos, max.bpos)]) {
+			_run(f2, ge2, max.apos, 'D');
+		} else {
+			if(a[max.apos - 1] != b[max.bpos - 1]) {
+				result.path[--path_index] = 'X';
+			} else {
+				result.path[--path_index] = 'M';
+			}
+			max.apos--;
+			max.bpos--;
+		}
+	}
+	#undef _run
+
+	result.path_length -= path_index;
+	for(uint64_t i = 0; i < result.path_length; i++) {
+		result.path[i] = result.path[path_index++];
+	}
+	result.path[result.path_length] = '\0';
+
+	free(mat);
+
+	#undef a
+	#undef f
+	#undef e
+	#undef f2
+	#undef e2
+	#undef s
+	return(result);
+}
+
+/**
+ * @fn sw_multi_cell
+ *
+ * @brief cell (i, j) of sw_multi_affine under the K schemes: h, f, and e of the cell
+ * from the left (hl), upper (g), and diagonal (gd) ones, with the max of the row and its
+ * column; the fields never overlap, which restrict tells the vectorizer
+ */
+static inline
+void sw_multi_cell(
+	uint64_t K, uint64_t j,
+	int16_t *restrict h, int16_t *restrict f, int16_t *restrict e,
+	int16_t const *restrict hl, int16_t const *restrict g, int16_t const *restrict gd,
+	int16_t const *restrict s, int16_t const *restrict gi, int16_t const *restrict ge, int16_t const *restrict min,
+	int16_t *restrict rmax, uint32_t *restrict rpos)
+{
+	for(uint64_t k = 0; k < K; k++) {
+		int16_t const score_f = f[k] = MAX2(g[k] + gi[k], f[k] + ge[k]);
+		int16_t const score_e = e[k] = MAX2(hl[k] + gi[k], e[k] + ge[k]);
+		int16_t const score = h[k] = MAX4(min[k], gd[k] + s[k], score_f, score_e);
+		rpos[k] = score > rmax[k] ? (uint32_t)j : rpos[k];
+		rmax[k] = MAX2(rmax[k], score);
+	}
+	return;
+}
+
+/**
+ * @fn sw_multi_affine
+ *
+ * @brief sw_affine under each of the scnt schemes of sc (m and x on the 16-entry
+ * matrix), in one pass over the matrix: a cell holds the scnt schemes side by side
+ * so that the innermost loop runs over them. Scores and end cells only (path NULL),
+ * on two rows per field; the reference of adaptive_ms.
+ */
+void sw_multi_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	scheme_t const *sc, uint64_t scnt, sw_result_t *r)
+{
+	uint64_t const K = scnt;
+	int16_t *mem = (int16_t *)malloc(sizeof(int16_t) * K * (3 * (blen + 1) + 8) + sizeof(uint32_t) * K);
+	int16_t *h = mem, *g = h + K * (blen + 1), *f = g + K * (blen + 1);
+	int16_t *e = f + K * (blen + 1), *gi = e + K, *ge = gi + K, *m = ge + K, *x = m + K, *min = x + K;
+	int16_t *gap = min + K, *rmax = gap + K;
+	uint32_t *rpos = (uint32_t *)(rmax + K);		/* the max of the row and its first column */
+
+	/* gi fixed with ge, and the floor of sw_affine */
+	for(uint64_t k = 0; k < K; k++) {
+		gi[k] = sc[k].gi + sc[k].ge; ge[k] = sc[k].ge; m[k] = sc[k].m; x[k] = sc[k].x;
+		min[k] = INT16_MIN - MIN2(sc[k].m, sc[k].x) - sc[k].gi;
+		gap[k] = gi[k] - ge[k] - 1;
+		r[k] = (sw_result_t){ .score = 0, .path_length = 0, .apos = 0, .bpos = 0, .path = NULL };
+	}
+
+	/* init, the same expressions as sw_affine; g holds the row above */
+	for(uint64_t k = 0; k < K; k++) { g[k] = f[k] = 0; }
+	for(uint64_t j = 1; j < blen+1; j++) {
+		for(uint64_t k = 0; k < K; k++) {
+			g[j * K + k] = MAX2(min[k], gi[k] + (j - 1) * ge[k]);
+			f[j * K + k] = MAX2(min[k], gi[k] + (j - 1) * ge[k] + gap[k]);
+		}
+	}
+
+	for(uint64_t i = 1; i < alen+1; i++) {
+		for(uint64_t k = 0; k < K; k++) {
+			h[k] = MAX2(min[k], gi[k] + (i - 1) * ge[k]);
+			e[k] = MAX2(min[k], gi[k] + (i - 1) * ge[k] + gap[k]);
+			rmax[k] = 0; rpos[k] = 0;
+		}
+		int8_t const ca = encode_a(a[i - 1]);
+		for(uint64_t j = 1; j < blen+1; j++) {
+			sw_multi_cell(K, j, &h[j * K], &f[j * K], e, &h[(j - 1) * K], &g[j * K], &g[(j - 1) * K],
+				ca == (encode_b(b[j - 1])>>2) ? m : x, gi, ge, min, rmax, rpos);
+		}
+		/* the max of the row at its first column, taken when above the max so far (the row-major scan of sw_affine) */
+		for(uint64_t k = 0; k < K; k++) {
+			if(rmax[k] > r[k].score) { r[k].score = rmax[k]; r[k].apos = i; r[k].bpos = rpos[k]; }
+		}
+		int16_t *t = g; g = h; h = t;
+	}
+	free(mem);
+	return;
+}
+
 #ifdef TEST
 #include <stdio.h>
 #include <assert.h>
@@ -182,10 +578,133 @@ void test_affine_1_1_1(void)
 	#undef a
 }
 
+void test_dual_affine(void)
+{
+	int8_t score_matrix[16] __attribute__(( aligned(16) ));
+	build_score_matrix(score_matrix, 2, -4);
+
+	#define d(s, p, q, g1, g2) { \
+		sw_result_t r = sw_dual_affine(p, strlen(p), q, strlen(q), score_matrix, g1[0], g1[1], g2[0], g2[1]); \
+		assert(r.score == (s)); \
+		if(r.path != NULL) { free(r.path); } \
+	}
+	int8_t const q[2] = { -4, -2 }, q2[2] = { -24, -1 }, n2[2] = { -100, -2 };
+	/* the second pair never wins on short gaps; the same as sw_affine */
+	d(16, "AAAAAAAA", "AAAAAAAA", q, q2);
+	d(26, "ACGTACGTACGTACGT", "ACGTACGTTACGTACGT", q, q2);
+	/* a 30-base deletion between 40-base flanks costs 4 + 60 on the first pair, 24 + 30 on the second */
+	#define L	"GCTAAAGACAATTACATAACATACACGTCAGCACGAAACT"
+	#define R	"AAGTAAGTGTGATGCATACGCCTTTACTTGCTGTGTCCAC"
+	d(160 - 54, L "TGTTGGCCCAGTGTGAATCGCTTAAGGGTT" R, L R, q, q2);
+	/* a second pair that never wins gives the affine score */
+	d(160 - 64, L "TGTTGGCCCAGTGTGAATCGCTTAAGGGTT" R, L R, q, n2);
+	#undef L
+	#undef R
+	#undef d
+}
+
+void test_local_endfree(void)
+{
+	int8_t score_matrix[16] __attribute__(( aligned(16) ));
+	build_score_matrix(score_matrix, 2, -3);
+
+	#define m(f, s, p, q) { \
+		sw_result_t r = f(p, strlen(p), q, strlen(q), score_matrix, -5, -1); \
+		assert(r.score == (s)); \
+		if(r.path != NULL) { free(r.path); } \
+	}
+	m(sw_local,    0, "", "");
+	m(sw_local,    0, "AAAA", "TTTT");
+	/* the mismatching heads cost 12 on extension, nothing on local */
+	m(sw_affine,   4, "GGGGACGTACGTCCCC", "TTTTACGTACGTAAAA");
+	m(sw_local,   16, "GGGGACGTACGTCCCC", "TTTTACGTACGTAAAA");
+	/* the end-free extension has to reach the end of a (mismatching the last A) or of b */
+	m(sw_affine,  16, "ACGTACGTA", "ACGTACGTTTTTT");
+	m(sw_endfree, 13, "ACGTACGTA", "ACGTACGTTTTTT");
+	m(sw_endfree, 12, "ACGTACGTACGT", "ACGTAC");
+	m(sw_endfree,  0, "AAAA", "TTTT");
+	/* global pays for all of both, down to below zero */
+	m(sw_global,   0, "", "");
+	m(sw_global,  -8, "", "AAA");
+	m(sw_global, -12, "AAAA", "TTTT");
+	m(sw_global,   4, "ACGTACGTA", "ACGTACGTTTTTT");
+	#undef m
+}
+
+#include "parasail/matrices/blosum62.h"
+void test_aa_affine(void)
+{
+	aa_matrix_t m;
+	build_aa_matrix(&m, parasail_blosum62.matrix, parasail_blosum62.mapper, parasail_blosum62.size);
+
+	#define p(s, p, q) { \
+		sw_result_t r = sw_aa_affine(p, strlen(p), q, strlen(q), &m, -10, -1); \
+		assert(r.score == (s)); \
+		if(r.path != NULL) { free(r.path); } \
+	}
+	p( 0, "", "");
+	p(22, "WW", "WW");
+	p(14, "MKV", "MKV");
+	/* deleting A (11) beats A against W (-3) losing the last W (11) */
+	p(77, "WWWWAWWWW", "WWWWWWWW");
+	#undef p
+}
+
+void test_qv_affine(void)
+{
+	/* bin 0 (below 20) scores matches 0, bin 1 scores them 2; mismatches -3 on both */
+	int8_t const m[2] = { 0, 2 }, x[2] = { -3, -3 };
+	uint8_t const thresh[2] = { 0, 20 };
+	qv_matrix_t qv;
+	build_qv_matrix(&qv, m, x, thresh, 2);
+
+	#define q(s, p, r, qual) { \
+		sw_result_t t = sw_qv_affine(p, strlen(p), r, strlen(r), &qv, (uint8_t const *)(qual), -5, -1); \
+		assert(t.score == (s)); \
+		if(t.path != NULL) { free(t.path); } \
+	}
+	q(16, "ACGTACGT", "ACGTACGT", "\x28\x28\x28\x28\x28\x28\x28\x28");
+	/* the low-quality half earns nothing */
+	q( 8, "ACGTACGTACGT", "ACGTACGTACGT", "\x28\x28\x28\x28\x05\x05\x05\x05\x05\x05\x05\x05");
+	q(16, "ACGTACGTACGT", "ACGTACGTACGT", "\x28\x28\x28\x28\x28\x28\x28\x28\x05\x05\x05\x05");
+	#undef q
+}
+
+void test_multi_affine(void)
+{
+	/* the schemes of t, a zero-cost gap, and the gi-ge corners; each the same as sw_affine alone */
+	scheme_t sc[8];
+	for(uint64_t k = 0; k < 4; k++) { sc[k] = (scheme_t){ t[k][0], t[k][1], t[k][2], t[k][3], 0 }; }
+	sc[4] = (scheme_t){ 2, -2, 0, 0, 0 }; sc[5] = (scheme_t){ 2, -2, 0, -5, 0 };
+	sc[6] = (scheme_t){ 2, -2, -5, 0, 0 }; sc[7] = (scheme_t){ 2, -2, -5, -5, 0 };
+	char const *p[][2] = {
+		{ "", "" }, { "A", "" }, { "AAA", "TTT" },
+		{ "AAACACGTGGG", "AAAACGTTTTTTTT" },
+		{ "ACGTACGTTACGTACGTAAGTTCA", "ACGTACGTACGTTACGTAAGTCA" },
+		{ "GCTAAAGACAATTACATAACATACACGTCAGCACGAAACT", "GCTAAAGACATTACATAACGATACACGTCAGCACTTAAACT" }
+	};
+	for(uint64_t i = 0; i < sizeof(p) / sizeof(p[0]); i++) {
+		sw_result_t r[8];
+		sw_multi_affine(p[i][0], strlen(p[i][0]), p[i][1], strlen(p[i][1]), sc, 8, r);
+		for(uint64_t k = 0; k < 8; k++) {
+			int8_t score_matrix[16] __attribute__(( aligned(16) ));
+			build_score_matrix(score_matrix, sc[k].m, sc[k].x);
+			sw_result_t q = sw_affine(p[i][0], strlen(p[i][0]), p[i][1], strlen(p[i][1]), score_matrix, sc[k].gi, sc[k].ge);
+			assert(r[k].score == q.score && r[k].apos == q.apos && r[k].bpos == q.bpos && r[k].path == NULL);
+			free(q.path);
+		}
+	}
+}
+
 int main(void)
 {
 	test_linear_1_1_1();
 	test_affine_1_1_1();
+	test_dual_affine();
+	test_local_endfree();
+	test_aa_affine();
+	test_qv_affine();
+	test_multi_affine();
 	return(0);
 }
 #endif
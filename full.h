@@ -34,6 +34,58 @@ sw_result_t sw_affine(
 	int8_t *score_matrix, int8_t gi, int8_t ge);
 	// int8_t m, int8_t x, int8_t gi, int8_t ge);
 
+sw_result_t sw_local(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge);
+
+sw_result_t sw_endfree(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge);
+
+sw_result_t sw_global(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge);
+
+struct aa_matrix_s;
+sw_result_t sw_aa_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	struct aa_matrix_s const *aa, int8_t gi, int8_t ge);
+
+struct qv_matrix_s;
+sw_result_t sw_qv_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	struct qv_matrix_s const *qv, uint8_t const *qa, int8_t gi, int8_t ge);
+
+sw_result_t sw_dual_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int8_t gi2, int8_t ge2);
+
+struct scheme_s;
+void sw_multi_affine(
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	struct scheme_s const *sc, uint64_t scnt, sw_result_t *r);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,32 @@
+
+/**
+ * @file isa.h
+ *
+ * @brief instruction set tag of the kernel builds
+ *
+ * @detail
+ * The SIMD kernels are compiled once per instruction set with -DISA=<tag>
+ * (sse41, avx2, or avx512; see makefile), and the exported functions are
+ * suffixed with the tag, e.g. adaptive_affine_avx2. main.cc collects the
+ * variants into the dispatch table and picks the widest one the processor
+ * supports at startup.
+ *
+ * Classes and inline functions in the headers included by the kernels must
+ * have internal linkage (static or in an unnamed namespace), otherwise the
+ * linker may pick an AVX2-compiled copy for the SSE4.1 variant.
+ */
+#ifndef _ISA_H_INCLUDED
+#define _ISA_H_INCLUDED
+
+#ifndef ISA
+#  define ISA 					sse41
+#endif
+
+#define _isa_cat_intl(x, y)		x##_##y
+#define _isa_cat(x, y)			_isa_cat_intl(x, y)
+#define _isa(_name)				_isa_cat(_name, ISA)
+
+#endif /* #ifndef _ISA_H_INCLUDED */
+/**
+ * end of isa.h
+ */
@@ -11,9 +11,11 @@
 #include <getopt.h>
 #include <sys/time.h>
 #include "util.h"
+#include "seq.h"
 #include "kvec.h"
 #include "bench.h"
 #include "parasail.h"
+#include "parasail/cpuid.h"
 #include "ssw.h"
 #include "full.h"
 
@@ -21,11 +23,16 @@
 #define X 					( 1 )
 #define GI 					( 1 )
 #define GE 					( 1 )
+#define GI2					( 24 )			/* the second gap pair of the dual-affine kernels (minimap2) */
+#define GE2					( 1 )
+#define QV_PIPE				( 40 )			/* quality of piped sequences */
 #define XDROP				( 70 )			// equal to the default of blastn (X = 100 (bit)) w/ (M, X, Gi, Ge) = (1, -1, 2, 1)
 
 // #define OMIT_SCORE			1
 #define PARASAIL_SCORE		1
 #define RECALL_THRESH		0.99
+#define SWEEP_MAX_BW		( 256 )
+#define WORK_SIZE			( 1024ULL * 1024 * 1024 )
 // #define DEBUG_PATH
 // #define DEBUG_BLAST			1
 
@@ -36,12 +43,135 @@ typedef struct { size_t n, m; int32_t *a; } int32_v;
 
 #define _base_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt, uint32_t bw
 int scalar_affine(_base_signature);
-int vertical_affine(_base_signature);
-int diagonal_affine(_base_signature);
-int striped_affine(_base_signature);
 int blast_affine(_base_signature);
-int simdblast_affine(_base_signature);
-int adaptive_affine(_base_signature);
+
+/* multi-X pass: the results at each of the xcnt sorted thresholds of xt to xr (see adaptive.cc and blast.cc) */
+#define _mx_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, int8_t *score_matrix, int8_t gi, int8_t ge, int16_t const *xt, uint64_t xcnt, uint32_t bw, xdrop_result_t *xr
+int blast_mx(_mx_signature);
+
+/* multi-scheme pass: the results under each of the scnt schemes of sc to r (see adaptive.cc) */
+#define _ms_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, scheme_t const *sc, uint64_t scnt, uint32_t bw, xdrop_result_t *r
+
+/* dual affine gap: the better of (gi, ge) and (gi2, ge2) per gap (see adaptive.cc) */
+#define _dual_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, int8_t *score_matrix, int8_t gi, int8_t ge, int8_t gi2, int8_t ge2, int16_t xt, uint32_t bw
+
+/* protein scoring: aa in place of the 16-entry matrix (see adaptive.cc) */
+#define _aa_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, aa_matrix_t const *aa, int8_t gi, int8_t ge, int16_t xt, uint32_t bw
+
+/* quality-aware scoring: the table of qv picked by the quality in qa of each base of a (see adaptive.cc and simdblast.cc) */
+#define _qv_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, qv_matrix_t const *qv, uint8_t const *qa, int8_t gi, int8_t ge, int16_t xt, uint32_t bw
+
+/* global with the path: the score of the end cell, the path (M, X, I, D as full.c) to path, empty if it could not be traced (see adaptive.cc) */
+#define _path_signature			void *work, char const *a, uint64_t alen, char const *b, uint64_t blen, int8_t *score_matrix, int8_t gi, int8_t ge, uint32_t bw, char *path
+
+/* SIMD kernels, built once per instruction set (see isa.h) */
+enum isa_e { SSE41 = 0, AVX2 = 1, AVX512 = 2, ISA_CNT = 3 };
+static char const *isa_names[ISA_CNT] = { "sse41", "avx2", "avx512" };
+static uint32_t const isa_lanes[ISA_CNT] = { 8, 16, 32 };	/* 16-bit cells per vector */
+
+#define _decl(_name) \
+	int _name##_sse41(_base_signature); \
+	int _name##_avx2(_base_signature); \
+	int _name##_avx512(_base_signature);
+_decl(vertical_affine);
+_decl(diagonal_affine);
+_decl(striped_affine);
+_decl(simdblast_affine);
+_decl(adaptive_affine);
+
+/* linear-gap kernels (see adaptive.cc and simdblast.cc) */
+_decl(adaptive_linear);
+_decl(simdblast_linear);
+
+/* dual affine gap, the second pair after the first (see adaptive.cc) */
+int adaptive_dual_sse41(_dual_signature);
+int adaptive_dual_avx2(_dual_signature);
+int adaptive_dual_avx512(_dual_signature);
+
+/* protein scoring with the matrices of parasail (see adaptive.cc) */
+int adaptive_protein_sse41(_aa_signature);
+int adaptive_protein_avx2(_aa_signature);
+int adaptive_protein_avx512(_aa_signature);
+
+/* local and anchored end-free modes (see adaptive.cc) */
+_decl(adaptive_local);
+_decl(adaptive_endfree);
+
+/* global gap filling between anchors (see adaptive.cc) */
+_decl(adaptive_global);
+int adaptive_global_path_sse41(_path_signature);
+int adaptive_global_path_avx2(_path_signature);
+int adaptive_global_path_avx512(_path_signature);
+
+/* quality-aware scoring (see adaptive.cc and simdblast.cc) */
+int adaptive_qv_sse41(_qv_signature);
+int adaptive_qv_avx2(_qv_signature);
+int adaptive_qv_avx512(_qv_signature);
+int simdblast_qv_sse41(_qv_signature);
+int simdblast_qv_avx2(_qv_signature);
+int simdblast_qv_avx512(_qv_signature);
+
+int adaptive_mx_sse41(_mx_signature);
+int adaptive_mx_avx2(_mx_signature);
+int adaptive_mx_avx512(_mx_signature);
+
+int adaptive_ms_sse41(_ms_signature);
+int adaptive_ms_avx2(_ms_signature);
+int adaptive_ms_avx512(_ms_signature);
+
+/* streaming extension, b fed in chunks (see adaptive.cc) */
+_decl(adaptive_stream_affine);
+
+/* band state layouts (see adaptive.cc) */
+_decl(adaptive_soa_affine);
+_decl(adaptive_hybrid_affine);
+
+/* termination policy variants of the adaptive band (see adaptive.cc) */
+_decl(adaptive_xband_affine);
+_decl(adaptive_zdrop_affine);
+
+/* branch-free direction selection (see adaptive.cc) */
+_decl(adaptive_blend_affine);
+
+/* path counters at the max, left in maxpos_t (see adaptive.cc) */
+_decl(adaptive_ident_affine);
+
+/* band steering policies (see adaptive.cc) */
+_decl(adaptive_edgemax_affine);
+_decl(adaptive_gapsteer_affine);
+_decl(adaptive_argmax_affine);
+_decl(adaptive_hyst_affine);
+
+/* dynamic band width (see adaptive.cc) */
+_decl(adaptive_widen_affine);
+
+/* fallback chain, the stage each pair ended at left in maxpos_t (see adaptive.cc) */
+_decl(adaptive_chain_affine);
+
+/* sequence view variants (see seq.h) */
+_decl(simdblast_rv_affine);
+_decl(simdblast_rc_affine);
+_decl(adaptive_rv_affine);
+_decl(adaptive_rc_affine);
+_decl(simdblast_pk_affine);
+_decl(adaptive_pk_affine);
+
+/* register-resident wide-band kernels; band width fixed at compile time (see wide.cc) */
+_decl(wide64_affine);
+_decl(wide128_affine);
+_decl(wide256_affine);
+#undef _decl
+
+/**
+ * @fn detect_isa
+ * @brief the widest instruction set available on the processor
+ */
+uint64_t detect_isa(void)
+{
+	if(parasail_can_use_avx512bw()) { return(AVX512); }
+	if(parasail_can_use_avx2()) { return(AVX2); }
+	return(SSE41);
+}
 
 /* wrapper of Myers' wavefront algorithm */
 extern "C" {
@@ -152,18 +282,13 @@ void print_alignment(char const *a, uint64_t alen, char const *b, uint64_t blen,
 
 /**
  * random sequence generator, modifier.
- * rseq generates random nucleotide sequence in ascii,
+ * rseq generates random nucleotide (or amino acid, see -P) sequence in ascii,
  * mseq takes ascii sequence, modifies the sequence in given rate.
  */
+static char const *rbase_alphabet = "ACGT";
 static char rbase(void)
 {
-	switch(rand() % 4) {
-		case 0: return 'A';
-		case 1: return 'C';
-		case 2: return 'G';
-		case 3: return 'T';
-		default: return 'A';
-	}
+	return(rbase_alphabet[rand() % strlen(rbase_alphabet)]);
 }
 
 char *rseq(int len)
@@ -197,26 +322,6 @@ char *mseq(char const *seq, int x, int ins, int del)
 	return(mod);
 }
 
-void revcomp(char *seq, int len)
-{
-	char map[32] = {
-		0, 'T' & 0x1f, 0, 'G' & 0x1f, 0, 0, 0, 'C' & 0x1f, 0, 0, 0, 0, 0, 0, 0, 0,
-		0, 0, 0, 0, 'A' & 0x1f, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
-	};
-
-	/* in-place revcomp */
-	char *p = seq, *q = &seq[len - 1];
-	while(p < q) {
-		char t = *p;
-		*p = map[*q & 0x1f] | (*q & ~0x1f);
-		*q = map[t & 0x1f] | (t & ~0x1f);
-		p++; q--;
-	}
-
-	if(p == q) { *p = map[*p]; }
-	return;
-}
-
 int print_msg(int flag, char const *fmt, ...)
 {
 	int r = 0;
@@ -242,20 +347,40 @@ int print_bench(int flag, char const *name, int64_t b, int64_t score)
 }
 
 
+/* the full dp references the kernels are scored against, one per gap model and alignment mode (ref_table) */
+enum ref_e { REF_AFFINE = 0, REF_LINEAR = 1, REF_DUAL = 2, REF_LOCAL = 3, REF_ENDFREE = 4, REF_GLOBAL = 5, REF_QV = 6, REF_CNT = 7 };
+struct ref_s {
+	int32_v score;
+	uint64_v apos, bpos;			/* end of the alignment */
+};
+
 struct params_s {
 	int8_t score_matrix[16];
-	int m, x, gi, ge, xt;
+	int m, x, gi, ge, gi2, ge2, xt;
+	int16_t xs[XDROP_LIST_MAX];		/* thresholds of the multi-X kernels (-X), sorted; xt alone if xcnt is 0 */
+	uint64_t xcnt;
+	scheme_t sc[SCHEME_MAX];		/* schemes of the multi-scheme kernels (-S); -p alone if not given */
+	uint64_t scnt;
 	uint32_t bw;
 	uint64_t max_cnt, max_len, tail_len;
+	double identity;
+	double recall;					/* target recall of the band width sweep, 0 to disable */
 	uint64_t flag, rdseed, pipe, revcomp;
+	uint64_t isa;
 	char *list;
+	parasail_matrix_t const *protein;	/* protein mode (-P), NULL for nucleotides */
+	aa_matrix_t aa;					/* table of the protein kernels; the nucleotide scoring unless in protein mode */
+	qv_matrix_t qv;					/* table of the quality-aware kernels, built from -p */
 
 	uint8_v buf;
+	uint8_v qual;					/* quality of each base in buf */
 	ptr_v seq;
 	uint64_v len;
-	int32_v ascore;
-	uint64_v apos;
-	uint64_v bpos;
+	uint8_v pbuf;					/* 2-bit packed copy of buf (see seq.h), filled if any packed kernel is listed */
+	ptr_v pseq;
+	struct ref_s ref[REF_CNT];		/* full dp results of each reference (ref_table), filled if any kernel checked against it is listed */
+	int32_v mscore;					/* multi-scheme references, scnt per pair, filled if any multi-scheme kernel is listed */
+	uint64_v icnt;					/* matches, aligned columns, and gap opens on the traceback of REF_AFFINE, 3 per pair, filled if any identity kernel is listed */
 
 	void *work;
 };
@@ -263,27 +388,40 @@ struct params_s {
 void init_args(struct params_s *p)
 {
 	build_score_matrix(p->score_matrix, M, -X);
-	p->m = M; p->x = -X; p->gi = -GI; p->ge = -GE;
+	p->m = M; p->x = -X; p->gi = -GI; p->ge = -GE; p->gi2 = -GI2; p->ge2 = -GE2;
 	p->xt = XDROP;
+	p->xcnt = 0;
+	p->scnt = 0;
 	p->bw = 32;
 	p->max_len = 10000;
 	p->max_cnt = 1000;
 	p->tail_len = 0;
+	p->identity = 0.85;
+	p->recall = 0.0;
 	p->flag = 0;
 	p->rdseed = 0;
 	p->pipe = 0;
 	p->revcomp = 0;
+	p->isa = detect_isa();
+	p->protein = NULL;
 	p->list = mm_strdup("scalar,vertical,diagonal,striped,adaptive,blast,simdblast");
 
 	kv_init(p->buf);
+	kv_init(p->qual);
 	kv_init(p->seq);
 	kv_init(p->len);
-	kv_init(p->ascore);
-	kv_init(p->apos);
-	kv_init(p->bpos);
+	kv_init(p->pbuf);
+	kv_init(p->pseq);
+	for(uint64_t k = 0; k < REF_CNT; k++) {
+		kv_init(p->ref[k].score);
+		kv_init(p->ref[k].apos);
+		kv_init(p->ref[k].bpos);
+	}
+	kv_init(p->mscore);
+	kv_init(p->icnt);
 
 	/* malloc work */
-	p->work = aligned_malloc(1024 * 1024 * 1024, sizeof(__m128i));
+	p->work = aligned_malloc(WORK_SIZE, ARENA_ALIGN);		/* aligned for AVX-512 and the cache line */
 
 	struct timeval tv;
 	gettimeofday(&tv, NULL);
@@ -295,11 +433,18 @@ void clean_args(struct params_s *p)
 {
 	free(p->list);
 	free(p->buf.a);
+	free(p->qual.a);
 	free(p->seq.a);
 	free(p->len.a);
-	free(p->ascore.a);
-	free(p->apos.a);
-	free(p->bpos.a);
+	free(p->pbuf.a);
+	free(p->pseq.a);
+	for(uint64_t k = 0; k < REF_CNT; k++) {
+		free(p->ref[k].score.a);
+		free(p->ref[k].apos.a);
+		free(p->ref[k].bpos.a);
+	}
+	free(p->mscore.a);
+	free(p->icnt.a);
 	free(p->work);
 	return;
 }
@@ -314,10 +459,60 @@ int parse_args(struct params_s *p, int c, char *arg)
 		case 'n': free(p->list); p->list = mm_strdup(arg); break;
 		case 'b': p->bw = atoi(arg); break;
 		case 'x': p->xt = atoi(arg); break;
+		case 'X': {
+			int16_t *xs = p->xs;
+			uint64_t n = 0;
+			mm_split_foreach(arg, ",", { if(i < XDROP_LIST_MAX) { xs[i] = atoi(p); n = i + 1; } });
+			for(uint64_t i = 1; i < n; i++) {
+				for(uint64_t j = i; j > 0 && xs[j - 1] > xs[j]; j--) { int16_t t = xs[j]; xs[j] = xs[j - 1]; xs[j - 1] = t; }
+			}
+			p->xcnt = n;
+		} break;
+		case 'S': {
+			/* M,X,GI,GE[,XT] per scheme, apart with ':'; the magnitudes of -p, XT of -x or the name if left out */
+			scheme_t *sc = p->sc;
+			int v[5] = { M, X, GI, GE, -1 };
+			uint64_t n = 0, f = 0;
+			mm_split_foreach(arg, ",:", {
+				if(f < 5) { v[f] = atoi(p); }
+				f++;
+				if(p[l] != ',') {
+					if(n < SCHEME_MAX) { sc[n].m = v[0]; sc[n].x = -v[1]; sc[n].gi = -v[2]; sc[n].ge = -v[3]; sc[n].xt = v[4]; n++; }
+					v[0] = M; v[1] = X; v[2] = GI; v[3] = GE; v[4] = -1; f = 0;
+				}
+			});
+			p->scnt = n;
+		} break;
 		case 'r': p->rdseed = atoi(arg); break;
 		case 'i': p->pipe = 1; break;
 		case 'R': p->revcomp = 1; break;
 		case 't': p->tail_len = atoi(arg); break;
+		case 'e': p->identity = atof(arg); break;
+		case 'w': p->recall = atof(arg); break;
+		case 'p': {
+			/* M,X,GI,GE[,GI2,GE2] in positive magnitudes, the same as the defaults above */
+			int v[6] = { M, X, GI, GE, GI2, GE2 };
+			mm_split_foreach(arg, ",", { if(i < 6) { v[i] = atoi(p); } });
+			build_score_matrix(p->score_matrix, v[0], -v[1]);
+			p->m = v[0]; p->x = -v[1]; p->gi = -v[2]; p->ge = -v[3]; p->gi2 = -v[4]; p->ge2 = -v[5];
+		} break;
+		case 'P':
+			p->protein = parasail_matrix_lookup(arg);
+			if(p->protein == NULL || p->protein->size > AA_DIM - AA_BASE - 1) {
+				fprintf(stderr, "unknown protein matrix: %s\n", arg);
+				return(1);
+			}
+			rbase_alphabet = "ARNDCQEGHILKMFPSTWYV";
+			break;
+		case 'A':
+			for(p->isa = 0; p->isa < ISA_CNT; p->isa++) {
+				if(strcmp(arg, isa_names[p->isa]) == 0) { break; }
+			}
+			if(p->isa == ISA_CNT) {
+				fprintf(stderr, "unknown instruction set: %s\n", arg);
+				return(1);
+			}
+			break;
 	}
 	return(0);
 }
@@ -350,6 +545,11 @@ uint64_t read_seq(struct params_s *params)
 	kv_push(params->seq, (char *)base);
 	kv_push(params->buf, '\0');
 
+	/* no qualities on the input; all at QV_PIPE */
+	kv_reserve(params->qual, kv_size(params->buf));
+	memset(params->qual.a, QV_PIPE, kv_size(params->buf));
+	params->qual.n = kv_size(params->buf);
+
 	for(i = 0; i < kv_size(params->seq); i++) {
 		kv_at(params->seq, i) = (uint8_t *)kv_at(params->seq, i) + (ptrdiff_t)params->buf.a;
 	}
@@ -358,12 +558,25 @@ uint64_t read_seq(struct params_s *params)
 
 uint64_t simulate_seq(struct params_s *params)
 {
+	/* mismatch : insertion : deletion = 4 : 1 : 1 of the divergence, 10:40:40 at 0.85 */
+	double d = MAX2(1.0 - params->identity, 1e-6);
+	int x = (int)(1.5 / d + 0.5), indel = (int)(6.0 / d + 0.5);
+
+	/* qualities on a generator of their own, keeping the sequences of a seed as they were */
+	uint64_t r = params->rdseed | 1;
+	#define rqual(_lo, _hi)		( r ^= r<<13, r ^= r>>7, r ^= r<<17, (_lo) + r % ((_hi) - (_lo) + 1) )
 	for(uint64_t i = 0; i < params->max_cnt; i++) {
 		char *a = rseq(params->max_len);
-		char *b = mseq(a, 10, 40, 40);
+		char *b = mseq(a, x, indel, indel);
 		char *at = rseq(params->max_len / 10);
 		char *bt = rseq(params->max_len / 10);
 
+		/* QV 20 to 40 on the body of a, 2 to 12 on its random tail; b is not used for scoring */
+		uint64_t const body = strlen(a), tail = strlen(at);
+		for(uint64_t j = 0; j < body; j++) { kv_push(params->qual, rqual(20, 40)); }
+		for(uint64_t j = 0; j < tail; j++) { kv_push(params->qual, rqual(2, 12)); }
+		kv_push(params->qual, 0);
+
 		a = (char *)realloc(a, 3 * params->max_len); strcat(a, at); free(at);
 		b = (char *)realloc(b, 3 * params->max_len); strcat(b, bt); free(bt);
 
@@ -377,9 +590,11 @@ uint64_t simulate_seq(struct params_s *params)
 		kv_push(params->seq, (void *)kv_size(params->buf));
 		kv_pushm(params->buf, b, strlen(b));
 		kv_push(params->buf, '\0');
+		for(uint64_t j = 0; j <= strlen(b); j++) { kv_push(params->qual, QV_PIPE); }
 
 		free(a); free(b);
 	}
+	#undef rqual
 
 	for(uint64_t i = 0; i < kv_size(params->seq); i++) {
 		kv_at(params->seq, i) = (uint8_t *)kv_at(params->seq, i) + (ptrdiff_t)params->buf.a;
@@ -387,118 +602,537 @@ uint64_t simulate_seq(struct params_s *params)
 	return(params->max_cnt);
 }
 
+/* 4 bases per byte, LSb first, each sequence from a byte boundary (pk_view in seq.h) */
+void pack_seq(struct params_s *params)
+{
+	uint64_t size = 0;
+	for(uint64_t i = 0; i < kv_size(params->seq); i++) { size += (kv_at(params->len, i) + 3) / 4 + 1; }
+	kv_reserve(params->pbuf, size);
+	memset(params->pbuf.a, 0, size);
+	params->pbuf.n = size;
+
+	uint8_t *q = params->pbuf.a;
+	for(uint64_t i = 0; i < kv_size(params->seq); i++) {
+		char const *p = (char const *)kv_at(params->seq, i);
+		for(uint64_t j = 0; j < kv_at(params->len, i); j++) { q[j>>2] |= encode(p[j])<<(2*(j & 0x03)); }
+		kv_push(params->pseq, (void *)q);
+		q += (kv_at(params->len, i) + 3) / 4 + 1;
+	}
+	return;
+}
+
+/* the qualities of a of the i-th pair */
+static inline uint8_t const *qual_of(struct params_s *p, uint64_t i)
+{
+	return(&kv_at(p->qual, (uint8_t *)kv_at(p->seq, i * 2) - p->buf.a));
+}
+
+/* the full dp of each reference on the i-th pair */
+#define _ref_pair(_p, _i) \
+	(char const *)kv_at((_p)->seq, (_i) * 2),     kv_at((_p)->len, (_i) * 2), \
+	(char const *)kv_at((_p)->seq, (_i) * 2 + 1), kv_at((_p)->len, (_i) * 2 + 1)
+
+static sw_result_t ref_affine(struct params_s *p, uint64_t i)
+{
+	if(p->protein != NULL) { return(sw_aa_affine(_ref_pair(p, i), &p->aa, p->gi, p->ge)); }
+	return(sw_affine(_ref_pair(p, i), p->score_matrix, p->gi, p->ge));
+
+	/* parasail has a bug
+	parasail_matrix_t *_matrix = parasail_matrix_create("ACGT", p->m, p->x);
+	parasail_result *r = parasail_sg_striped_sse41_128_16(_ref_pair(p, i), -p->gi - p->ge, -p->ge, _matrix);
+	score = r->score; apos = r->end_query + 1; bpos = r->end_ref + 1;
+	parasail_result_free(r);
+	*/
+}
+static sw_result_t ref_linear(struct params_s *p, uint64_t i) { return(sw_linear(_ref_pair(p, i), p->score_matrix, p->ge)); }
+static sw_result_t ref_dual(struct params_s *p, uint64_t i) { return(sw_dual_affine(_ref_pair(p, i), p->score_matrix, p->gi, p->ge, p->gi2, p->ge2)); }
+static sw_result_t ref_local(struct params_s *p, uint64_t i) { return(sw_local(_ref_pair(p, i), p->score_matrix, p->gi, p->ge)); }
+static sw_result_t ref_endfree(struct params_s *p, uint64_t i) { return(sw_endfree(_ref_pair(p, i), p->score_matrix, p->gi, p->ge)); }
+static sw_result_t ref_global(struct params_s *p, uint64_t i) { return(sw_global(_ref_pair(p, i), p->score_matrix, p->gi, p->ge)); }
+static sw_result_t ref_qv(struct params_s *p, uint64_t i) { return(sw_qv_affine(_ref_pair(p, i), &p->qv, qual_of(p, i), p->gi, p->ge)); }
+#undef _ref_pair
+
+/* indexed by ref_e; each filled when a kernel name with the tag is listed (REF_AFFINE always) */
+static struct {
+	char const *tag;
+	sw_result_t (*fp)(struct params_s *p, uint64_t i);
+} const ref_table[REF_CNT] = {
+	{ NULL, ref_affine },
+	{ "_linear", ref_linear },
+	{ "_dual", ref_dual },
+	{ "_local", ref_local },
+	{ "_endfree", ref_endfree },
+	{ "_global", ref_global },
+	{ "_qv", ref_qv }
+};
+
 void calc_score(struct params_s *params)
 {
-	kv_reserve(params->ascore, kv_size(params->seq) / 2);
-	kv_reserve(params->apos, kv_size(params->seq) / 2);
-	kv_reserve(params->bpos, kv_size(params->seq) / 2);
+	uint64_t const cnt = kv_size(params->seq) / 2;
+	for(uint64_t k = 0; k < REF_CNT; k++) {
+		kv_reserve(params->ref[k].score, cnt);
+		kv_reserve(params->ref[k].apos, cnt);
+		kv_reserve(params->ref[k].bpos, cnt);
+	}
 	#ifndef OMIT_SCORE
-		// parasail_matrix_t *_matrix = parasail_matrix_create("ACGT", params->m, params->x);
-		#pragma omp parallel for
-		for(uint64_t i = 0; i < kv_size(params->seq) / 2; i++) {
-
-			sw_result_t a = sw_affine(
-				(char const *)kv_at(params->seq, i * 2),     kv_at(params->len, i * 2),
-				(char const *)kv_at(params->seq, i * 2 + 1), kv_at(params->len, i * 2 + 1),
-				params->score_matrix, params->gi, params->ge
-			);
-			kv_at(params->ascore, i) = a.score;
-			kv_at(params->apos, i) = a.apos;
-			kv_at(params->bpos, i) = a.bpos;
-			free(a.path);
-
-			/* parasail has a bug
-			parasail_result *r = parasail_sg_striped_sse41_128_16(
-				(char const *)kv_at(params->seq, i * 2),     kv_at(params->len, i * 2),
-				(char const *)kv_at(params->seq, i * 2 + 1), kv_at(params->len, i * 2 + 1),
-				-params->gi - params->ge,
-				-params->ge,
-				_matrix
-			);
-			kv_at(params->ascore, i) = r->score;
-			kv_at(params->apos, i) = r->end_query + 1;
-			kv_at(params->bpos, i) = r->end_ref + 1;
-			parasail_result_free(r);
-			*/
+		/* the counters of the identity kernels on the traceback, only when one is to be run */
+		uint64_t const ident = strstr(params->list, "_ident") != NULL;
+		if(ident) { kv_reserve(params->icnt, 3 * cnt); }
+
+		for(uint64_t k = 0; k < REF_CNT; k++) {
+			if(ref_table[k].tag != NULL && strstr(params->list, ref_table[k].tag) == NULL) { continue; }
+			struct ref_s *ref = &params->ref[k];
+
+			#pragma omp parallel for
+			for(uint64_t i = 0; i < cnt; i++) {
+				sw_result_t a = ref_table[k].fp(params, i);
+				kv_at(ref->score, i) = a.score;
+				kv_at(ref->apos, i) = a.apos;
+				kv_at(ref->bpos, i) = a.bpos;
+				if(k == REF_AFFINE && ident) {
+					uint64_t m = 0, o = 0;
+					for(uint64_t j = 0; j < a.path_length; j++) {
+						m += a.path[j] == 'M';
+						o += (a.path[j] == 'I' || a.path[j] == 'D') && (j == 0 || a.path[j - 1] != a.path[j]);
+					}
+					kv_at(params->icnt, 3 * i) = m;
+					kv_at(params->icnt, 3 * i + 1) = a.path_length;
+					kv_at(params->icnt, 3 * i + 2) = o;
+				}
+				free(a.path);
+			}
+		}
+
+		/* multi-scheme references, all the schemes of a pair in a single pass */
+		if(strstr(params->list, "_ms") != NULL) {
+			uint64_t const scnt = params->scnt;
+			kv_reserve(params->mscore, scnt * cnt);
+			#pragma omp parallel for
+			for(uint64_t i = 0; i < cnt; i++) {
+				sw_result_t r[SCHEME_MAX];
+				sw_multi_affine(
+					(char const *)kv_at(params->seq, i * 2),     kv_at(params->len, i * 2),
+					(char const *)kv_at(params->seq, i * 2 + 1), kv_at(params->len, i * 2 + 1),
+					params->sc, scnt, r
+				);
+				for(uint64_t k = 0; k < scnt; k++) { kv_at(params->mscore, i * scnt + k) = r[k].score; }
+			}
 		}
 	#else
-		for(i = 0; i < kv_size(params->seq) / 2; i++) {
-			kv_at(params->ascore, i) = 0;
-			kv_at(params->apos, i) = 0;
-			kv_at(params->bpos, i) = 0;
+		for(uint64_t i = 0; i < cnt; i++) {
+			kv_at(params->ref[REF_AFFINE].score, i) = 0;
+			kv_at(params->ref[REF_AFFINE].apos, i) = 0;
+			kv_at(params->ref[REF_AFFINE].bpos, i) = 0;
 		}
 	#endif
 	return;
 }
 
+/* the fields not named in the initializers of the table in main are zero: the affine reference on ascii input */
 struct mapping_s {
 	char const *name;
-	int (*fp)(_base_signature);
+	int (*fp[ISA_CNT])(_base_signature);	/* indexed by isa_e */
+	uint64_t ref;							/* full dp reference scored against (ref_e) */
+	uint64_t pk;							/* takes a and b 2-bit packed (pseq) */
+	uint64_t ident;							/* leaves the path counters in maxpos_t, checked against the traceback */
+	uint64_t chain;							/* leaves the stage of the fallback chain in maxpos_t, counted per stage */
+	int (*mx[ISA_CNT])(_mx_signature);		/* multi-X pass, run over the thresholds of -X instead of fp */
+	int (*ms[ISA_CNT])(_ms_signature);		/* multi-scheme pass, run over the schemes of -S instead of fp */
+	int (*dual[ISA_CNT])(_dual_signature);	/* dual affine gap, run with the second pair of -p instead of fp */
+	int (*aa[ISA_CNT])(_aa_signature);		/* protein, run with the table of -P instead of fp */
+	int (*qv[ISA_CNT])(_qv_signature);		/* quality-aware, run with the table of -p and the qualities of a instead of fp */
+	int (*gp[ISA_CNT])(_path_signature);	/* global with the path, re-scored on the pair instead of fp */
 };
-void bench_function(struct params_s *params, struct mapping_s *map, char const *name)
+struct result_s {
+	int64_t time, score;
+	uint64_t hit;					/* #alignments scored >= RECALL_THRESH of the full dp */
+	uint64_t mcnt, lcnt, agree;		/* identity kernels: the sums of matches and aligned columns, and #pairs counted as the traceback */
+	uint64_t stage[CHAIN_STAGES];	/* fallback chain: #pairs ended at each stage */
+};
+void check_work(struct params_s *params, struct mapping_s *map, uint32_t bw)
 {
-	uint32_t bw = params->bw, xt = params->xt;
-	mm_split_foreach(name, ".", {
-		switch(i) {
-			case 1: bw = atoi(p); break;
-			case 2: xt = atoi(p); break;
-		}
-	});
+	/* the band state lives in the work arena; check that the longest pair fits */
+	uint64_t alen = 0, blen = 0;
+	for(uint64_t i = 0; i < kv_size(params->seq) / 2; i++) {
+		alen = MAX2(alen, kv_at(params->len, i * 2));
+		blen = MAX2(blen, kv_at(params->len, i * 2 + 1));
+	}
+	if(bw > BW_MAX || work_size(bw, alen, blen) > WORK_SIZE) {
+		fprintf(stderr, "%s: bw %u on %lu x %lu needs %zu bytes of work (max bw %d, %llu bytes)\n",
+			map->name, bw, alen, blen, work_size(bw, alen, blen), BW_MAX, WORK_SIZE);
+		exit(1);
+	}
+	return;
+}
+
+/* the kernel of map on the i-th pair, with the arguments of its signature */
+static inline int32_t call_function(struct params_s *params, struct mapping_s *map, uint64_t isa, uint64_t i, uint32_t xt, uint32_t bw)
+{
+	ptr_v const *seq = map->pk ? &params->pseq : &params->seq;
+	#define _pair \
+		(char const *)kv_at(*seq, i * 2),     kv_at(params->len, i * 2), \
+		(char const *)kv_at(*seq, i * 2 + 1), kv_at(params->len, i * 2 + 1)
+
+	int32_t s;
+	if(map->dual[0] != NULL) {
+		s = map->dual[isa](params->work, _pair, params->score_matrix, params->gi, params->ge, params->gi2, params->ge2, xt, bw);
+	} else if(map->aa[0] != NULL) {
+		s = map->aa[isa](params->work, _pair, &params->aa, params->gi, params->ge, xt, bw);
+	} else if(map->qv[0] != NULL) {
+		s = map->qv[isa](params->work, _pair, &params->qv, qual_of(params, i), params->gi, params->ge, xt, bw);
+	} else {
+		s = map->fp[isa](params->work, _pair, params->score_matrix, params->gi, params->ge, xt, bw);
+	}
+	#undef _pair
+	return(s);
+}
+
+struct result_s run_function(struct params_s *params, struct mapping_s *map, uint32_t bw, uint32_t xt)
+{
+	/* the band must be a multiple of the vector length; fall back to narrower ones if not */
+	uint64_t isa = params->isa;
+	while(isa > SSE41 && bw % isa_lanes[isa] != 0) { isa--; }
+
+	check_work(params, map, bw);
+
+	/* the full dp of the same gap model and mode */
+	struct ref_s const *ref = &params->ref[map->ref];
 
 	int64_t score = 0;
+	uint64_t hit = 0, mcnt = 0, lcnt = 0, agree = 0, stage[CHAIN_STAGES] = { 0 };
 	bench_t b;
 	bench_init(b);
 	for(uint64_t i = 0; i < kv_size(params->seq) / 2; i++) {
 		bench_start(b);
-		int32_t s = map->fp(params->work,
-			(char const *)kv_at(params->seq, i * 2),     kv_at(params->len, i * 2),
-			(char const *)kv_at(params->seq, i * 2 + 1), kv_at(params->len, i * 2 + 1),
-			params->score_matrix,
-			params->gi, params->ge,
-			xt, bw
-		);
+		int32_t s = call_function(params, map, isa, i, xt, bw);
 		bench_end(b);
 		score += s;
+		hit += s >= RECALL_THRESH * kv_at(ref->score, i);
 
 		maxpos_t *mp = (maxpos_t *)params->work;
-		if(s != kv_at(params->ascore, i) || mp->apos != kv_at(params->apos, i) || mp->bpos != kv_at(params->bpos, i)) {
+		if(map->chain) { stage[mp->stage]++; }
+		if(map->ident) {
+			uint64_t const *c = &kv_at(params->icnt, 3 * i);
+			mcnt += mp->mcnt; lcnt += mp->lcnt;
+			agree += mp->mcnt == c[0] && mp->lcnt == c[1] && mp->ocnt == c[2];
+		}
+		if(s != kv_at(ref->score, i) || mp->apos != kv_at(ref->apos, i) || mp->bpos != kv_at(ref->bpos, i)) {
 			debug("a(%s), b(%s)", kv_at(params->seq, i * 2), kv_at(params->seq, i * 2 + 1));
 			debug("i(%llu), score(%d, %d), apos(%llu, %llu), bpos(%llu, %llu)",
-				i, s, kv_at(params->ascore, i),
-				mp->apos, kv_at(params->apos, i),
-				mp->bpos, kv_at(params->bpos, i));
+				i, s, kv_at(ref->score, i),
+				mp->apos, kv_at(ref->apos, i),
+				mp->bpos, kv_at(ref->bpos, i));
 		}
 	}
 	bench_end(b);
-	print_bench(params->flag, name, bench_get(b), score);
+
+	struct result_s r = { bench_get(b), score, hit, mcnt, lcnt, agree, { stage[0], stage[1], stage[2], stage[3] } };
+	return(r);
+}
+
+/* a single pass per pair over the thresholds of -X (or xt alone), a line of the score sum at each */
+void curve_function(struct params_s *params, struct mapping_s *map, uint32_t bw, uint32_t xt)
+{
+	uint64_t isa = params->isa;
+	while(isa > SSE41 && bw % isa_lanes[isa] != 0) { isa--; }
+	check_work(params, map, bw);
+
+	int16_t const x1 = xt;
+	int16_t const *xs = params->xcnt != 0 ? params->xs : &x1;
+	uint64_t const xcnt = params->xcnt != 0 ? params->xcnt : 1;
+	int64_t score[XDROP_LIST_MAX] = { 0 };
+	xdrop_result_t xr[XDROP_LIST_MAX];
+
+	bench_t b;
+	bench_init(b);
+	for(uint64_t i = 0; i < kv_size(params->seq) / 2; i++) {
+		bench_start(b);
+		map->mx[isa](params->work,
+			(char const *)kv_at(params->seq, i * 2),     kv_at(params->len, i * 2),
+			(char const *)kv_at(params->seq, i * 2 + 1), kv_at(params->len, i * 2 + 1),
+			params->score_matrix, params->gi, params->ge,
+			xs, xcnt, bw, xr
+		);
+		bench_end(b);
+		for(uint64_t k = 0; k < xcnt; k++) { score[k] += xr[k].score; }
+	}
+
+	/* named as the single runs (<name>.<bw>.<xt>), each with the time of the whole pass */
+	for(uint64_t k = 0; k < xcnt; k++) {
+		char label[256];
+		snprintf(label, sizeof(label), "%s.%u.%d", map->name, bw, xs[k]);
+		print_bench(params->flag, label, bench_get(b), score[k]);
+	}
+	return;
+}
+
+/* the schemes of -S (or -p alone) in one adaptive_ms call, a line of the score sum and one of the recall against sw_multi_affine of each */
+void scheme_function(struct params_s *params, struct mapping_s *map, uint32_t bw, uint32_t xt)
+{
+	check_work(params, map, bw);
+
+	/* X of the schemes without their own from the name or -x */
+	uint64_t const scnt = params->scnt;
+	scheme_t sc[SCHEME_MAX];
+	for(uint64_t k = 0; k < scnt; k++) {
+		sc[k] = params->sc[k];
+		if(sc[k].xt < 0) { sc[k].xt = xt; }
+	}
+	int64_t score[SCHEME_MAX] = { 0 };
+	uint64_t hit[SCHEME_MAX] = { 0 };
+	xdrop_result_t r[SCHEME_MAX];
+
+	bench_t b;
+	bench_init(b);
+	for(uint64_t i = 0; i < kv_size(params->seq) / 2; i++) {
+		bench_start(b);
+		map->ms[params->isa](params->work,
+			(char const *)kv_at(params->seq, i * 2),     kv_at(params->len, i * 2),
+			(char const *)kv_at(params->seq, i * 2 + 1), kv_at(params->len, i * 2 + 1),
+			sc, scnt, bw, r
+		);
+		bench_end(b);
+		for(uint64_t k = 0; k < scnt; k++) {
+			score[k] += r[k].score;
+			hit[k] += r[k].score >= RECALL_THRESH * kv_at(params->mscore, i * scnt + k);
+		}
+	}
+
+	/* named <name>.<bw>.<xt>/<m>,<x>,<gi>,<ge> in the magnitudes of -p, each with the time of the whole pass */
+	uint64_t const cnt = MAX2(1, kv_size(params->seq) / 2);
+	for(uint64_t k = 0; k < scnt; k++) {
+		char label[256];
+		snprintf(label, sizeof(label), "%s.%u.%d/%d,%d,%d,%d", map->name, bw, sc[k].xt, sc[k].m, -sc[k].x, -sc[k].gi, -sc[k].ge);
+		print_bench(params->flag, label, bench_get(b), score[k]);
+		print_msg(params->flag, "%s\trecall: %.4f\n", label, (double)hit[k] / cnt);
+	}
+	return;
+}
+
+/* the score of the global path on a and b, INT64_MIN if it does not span both */
+static int64_t score_path(char const *a, uint64_t alen, char const *b, uint64_t blen, char const *path, int8_t const *score_matrix, int8_t gi, int8_t ge)
+{
+	int64_t s = 0;
+	uint64_t i = 0, j = 0;
+	for(char const *p = path; *p != '\0'; p++) {
+		if(*p == 'M' || *p == 'X') {
+			if(i >= alen || j >= blen) { return(INT64_MIN); }
+			s += score_matrix[encode_a(a[i++]) | encode_b(b[j++])];
+		} else {
+			s += (p == path || p[-1] != *p ? gi : 0) + ge;
+			if(*p == 'I') { j++; } else { i++; }
+		}
+	}
+	return(i == alen && j == blen ? s : INT64_MIN);
+}
+
+/* a line of the score sum and one of the pairs whose path re-scores to the score returned, and of the ones on the score of the full dp */
+void path_function(struct params_s *params, struct mapping_s *map, uint32_t bw)
+{
+	uint64_t isa = params->isa;
+	while(isa > SSE41 && bw % isa_lanes[isa] != 0) { isa--; }
+	check_work(params, map, bw);
+
+	uint64_t const cnt = kv_size(params->seq) / 2;
+	uint64_t plen = 1;
+	for(uint64_t i = 0; i < cnt; i++) { plen = MAX2(plen, kv_at(params->len, i * 2) + kv_at(params->len, i * 2 + 1) + 1); }
+	char *path = (char *)malloc(plen);
+
+	struct ref_s const *ref = &params->ref[map->ref];
+	int64_t score = 0;
+	uint64_t traced = 0, hit = 0;
+	bench_t b;
+	bench_init(b);
+	for(uint64_t i = 0; i < cnt; i++) {
+		char const *a = (char const *)kv_at(params->seq, i * 2), *q = (char const *)kv_at(params->seq, i * 2 + 1);
+		uint64_t const alen = kv_at(params->len, i * 2), blen = kv_at(params->len, i * 2 + 1);
+		bench_start(b);
+		int32_t s = map->gp[isa](params->work, a, alen, q, blen, params->score_matrix, params->gi, params->ge, bw, path);
+		bench_end(b);
+		score += s;
+		traced += score_path(a, alen, q, blen, path, params->score_matrix, params->gi, params->ge) == s;
+		hit += s == kv_at(ref->score, i);
+	}
+	free(path);
+
+	char label[256];
+	snprintf(label, sizeof(label), "%s.%u", map->name, bw);
+	print_bench(params->flag, label, bench_get(b), score);
+	print_msg(params->flag, "%s\trescored: %lu / %lu\tfull: %lu / %lu\n", label, traced, cnt, hit, cnt);
+	return;
+}
+
+void bench_function(struct params_s *params, struct mapping_s *map, char const *name)
+{
+	uint32_t bw = params->bw, xt = params->xt;
+	mm_split_foreach(name, ".", {
+		switch(i) {
+			case 1: bw = atoi(p); break;
+			case 2: xt = atoi(p); break;
+		}
+	});
+
+	if(map->mx[0] != NULL) {
+		curve_function(params, map, bw, xt);
+		return;
+	}
+	if(map->ms[0] != NULL) {
+		scheme_function(params, map, bw, xt);
+		return;
+	}
+	if(map->gp[0] != NULL) {
+		path_function(params, map, bw);
+		return;
+	}
+
+	if(params->recall == 0.0) {
+		struct result_s r = run_function(params, map, bw, xt);
+		print_bench(params->flag, name, r.time, r.score);
+
+		/* identity at the max over all the pairs, against the traceback of the full dp */
+		if(map->ident) {
+			uint64_t const cnt = kv_size(params->seq) / 2;
+			uint64_t m = 0, l = 0;
+			for(uint64_t i = 0; i < cnt; i++) { m += kv_at(params->icnt, 3 * i); l += kv_at(params->icnt, 3 * i + 1); }
+			print_msg(params->flag, "%s\tidentity: %.4f\ttraceback: %.4f\tagree: %lu / %lu\n", name,
+				(double)r.mcnt / MAX2(r.lcnt, 1), (double)m / MAX2(l, 1), r.agree, cnt);
+		}
+
+		/* pairs ended at each stage */
+		if(map->chain) {
+			print_msg(params->flag, "%s\tnarrow: %lu\twide: %lu\tsimdblast: %lu\texact: %lu\n", name,
+				r.stage[CHAIN_NARROW], r.stage[CHAIN_WIDE], r.stage[CHAIN_SIMDBLAST], r.stage[CHAIN_EXACT]);
+		}
+		return;
+	}
+
+	/* sweep mode: the narrowest band (in steps of the SSE4.1 vector) reaching the target recall */
+	uint64_t cnt = kv_size(params->seq) / 2;
+	for(bw = isa_lanes[SSE41]; bw <= SWEEP_MAX_BW; bw += isa_lanes[SSE41]) {
+		struct result_s r = run_function(params, map, bw, xt);
+		if(r.hit >= params->recall * cnt || bw == SWEEP_MAX_BW) {
+			print_msg(params->flag, "%s\t%u\t%.4f\t%ld\n", name, bw, (double)r.hit / cnt, r.time / 1000);
+			break;
+		}
+	}
 	return;
 }
 
 int main(int argc, char *argv[])
 {
 	/* name -> pointer mapping */
-	#define fn(_name)	{ #_name, _name##_affine }
+	#define _fp(_name)	{ _name##_sse41, _name##_avx2, _name##_avx512 }
+	#define fn(_name)	{ .name = #_name, .fp = _fp(_name##_affine) }
+	#define fs(_name)	{ .name = #_name, .fp = { _name##_affine, _name##_affine, _name##_affine } }	/* scalar */
+	#define fc(_name)	{ .name = #_name, .fp = _fp(_name##_affine), .chain = 1 }
+	#define fl(_name)	{ .name = #_name "_linear", .fp = _fp(_name##_linear), .ref = REF_LINEAR }
+	#define fd(_name)	{ .name = #_name "_dual", .ref = REF_DUAL, .dual = _fp(_name##_dual) }
+	#define fp(_name)	{ .name = #_name "_protein", .aa = _fp(_name##_protein) }
+	#define fo(_name, _mode, _r)	{ .name = #_name "_" #_mode, .fp = _fp(_name##_##_mode), .ref = _r }
+	#define fq(_name)	{ .name = #_name "_qv", .ref = REF_QV, .qv = _fp(_name##_qv) }
+	#define fk(_name)	{ .name = #_name "_pk", .fp = _fp(_name##_pk_affine), .pk = 1 }
+	#define fi(_name)	{ .name = #_name "_ident", .fp = _fp(_name##_ident_affine), .ident = 1 }
+	#define fx(_name)	{ .name = #_name "_mx", .mx = _fp(_name##_mx) }
+	#define fxs(_name)	{ .name = #_name "_mx", .mx = { _name##_mx, _name##_mx, _name##_mx } }	/* scalar */
+	#define fm(_name)	{ .name = #_name "_ms", .ms = _fp(_name##_ms) }
+	#define fg(_name)	{ .name = #_name "_global_path", .ref = REF_GLOBAL, .gp = _fp(_name##_global_path) }
 	struct mapping_s map[] = {
 		/* static banded w/ standard matrix */
-		fn(scalar), fn(vertical), fn(diagonal), fn(striped),
+		fs(scalar), fn(vertical), fn(diagonal), fn(striped),
 		/* non-standard banded */
-		fn(blast), fn(simdblast), fn(adaptive)
+		fs(blast), fn(simdblast), fn(adaptive), fn(adaptive_blend),
+		/* linear gap (-p m,x,gi,ge: gi ignored), scored against sw_linear */
+		fl(adaptive), fl(simdblast),
+		/* dual affine gap (-p m,x,gi,ge,gi2,ge2), scored against sw_dual_affine */
+		fd(adaptive),
+		/* protein matrices (-P blosum62 etc.), or the nucleotide scoring on a table without -P */
+		fp(adaptive),
+		/* local and anchored end-free modes, scored against sw_local and sw_endfree */
+		fo(adaptive, local, REF_LOCAL), fo(adaptive, endfree, REF_ENDFREE),
+		/* global, from (0, 0) to the end cell, scored against sw_global */
+		fo(adaptive, global, REF_GLOBAL),
+		/* the same with the path, re-scored on each pair (a line of the pairs it re-scores to the score on) */
+		fg(adaptive),
+		/* quality-aware scoring, 4 bins on the qualities of a derived from -p, scored against sw_qv_affine */
+		fq(adaptive), fq(simdblast),
+		/* b fed STREAM_CHUNK bases at a time, the band state moved between buffers in between */
+		fn(adaptive_stream),
+		/* one pass over the sorted thresholds of -X (xt alone without), a line per threshold */
+		fx(adaptive), fxs(blast),
+		/* the schemes of -S (-p alone without) in lane groups, a power of two of them per pass, a line per scheme */
+		fm(adaptive),
+		/* matches, aligned columns, and gap opens at the max, carried through the band (branching loop) */
+		fi(adaptive),
+		/* band state layouts: a plane per field, chars apart from scores */
+		fn(adaptive_soa), fn(adaptive_hybrid),
+		/* termination policies: whole-vector X-drop and Z-drop (adaptive_zdrop.<bw>.<z>) */
+		fn(adaptive_xband), fn(adaptive_zdrop),
+		/* steering policies */
+		fn(adaptive_edgemax), fn(adaptive_gapsteer), fn(adaptive_argmax), fn(adaptive_hyst),
+		/* widens the band while the max drops behind, up to 4x */
+		fn(adaptive_widen),
+		/* adaptive.<bw> -> adaptive.<4 * bw> -> simdblast or full dp on band loss */
+		fc(adaptive_chain),
+		/* leftward and reverse-complement extension */
+		fn(simdblast_rv), fn(simdblast_rc), fn(adaptive_rv), fn(adaptive_rc),
+		/* 2-bit packed input, scored against sw_affine as the ascii one */
+		fk(simdblast), fk(adaptive),
+		/* register-resident wide band (ignores -b) */
+		fn(wide64), fn(wide128), fn(wide256)
 	};
+	#undef _fp
 	#undef fn
+	#undef fs
+	#undef fc
+	#undef fl
+	#undef fd
+	#undef fp
+	#undef fo
+	#undef fq
+	#undef fx
+	#undef fxs
+	#undef fm
+	#undef fg
+	#undef fi
+	#undef fk
 
 	int i;
 	struct params_s params __attribute__(( aligned(16) ));
 	init_args(&params);
-	while((i = getopt(argc, argv, "l:c:san:b:x:r:iRt:")) != -1) {
+	while((i = getopt(argc, argv, "l:c:san:b:x:X:S:r:iRt:e:w:p:P:A:")) != -1) {
 		if(parse_args(&params, i, optarg) != 0) { exit(1); }
 	}
 
+	/* the scoring of -p alone without -S, X from the name or -x */
+	if(params.scnt == 0) {
+		params.sc[0] = (scheme_t){ (int8_t)params.m, (int8_t)params.x, (int8_t)params.gi, (int8_t)params.ge, -1 };
+		params.scnt = 1;
+	}
+
+	/* the table of the protein kernels, the nucleotide scoring on it without -P */
+	if(params.protein != NULL) {
+		build_aa_matrix(&params.aa, params.protein->matrix, params.protein->mapper, params.protein->size);
+	} else {
+		parasail_matrix_t *n = parasail_matrix_create("ACGT", params.m, params.x);
+		build_aa_matrix(&params.aa, n->matrix, n->mapper, n->size);
+		parasail_matrix_free(n);
+	}
+
+	/* QV < 10 as no information, scaling up to -p on QV >= 30 */
+	{
+		int8_t m[4], x[4];
+		uint8_t const thresh[4] = { 0, 10, 20, 30 };
+		for(int k = 0; k < 4; k++) { m[k] = (params.m * k + 1) / 3; x[k] = (params.x * k - 1) / 3; }
+		build_qv_matrix(&params.qv, m, x, thresh, 4);
+	}
+
 	srand(params.rdseed);
-	print_msg(params.flag, "seed:%lu\tm: %d\tx: %d\tgi: %d\tge: %d\txdrop: %d\tbw: %d\tmax_len: %d\tmax_cnt: %d\n",
+	print_msg(params.flag, "seed:%lu\tm: %d\tx: %d\tgi: %d\tge: %d\txdrop: %d\tbw: %d\tmax_len: %d\tmax_cnt: %d\tidentity: %.2f\tisa: %s\n",
 		params.rdseed,
 		params.m, params.x, params.gi, params.ge,
 		params.xt, params.bw,
-		params.max_len, params.max_cnt
+		params.max_len, params.max_cnt, params.identity,
+		isa_names[params.isa]
 	);
 
 	if(params.pipe != 0) {
@@ -509,10 +1143,12 @@ int main(int argc, char *argv[])
 
 	/* collect scores with full-sized dp */
 	calc_score(&params);
+	if(strstr(params.list, "_pk") != NULL) { pack_seq(&params); }
 	mm_split_foreach(params.list, ",", {
 		for(uint64_t j = 0; j < sizeof(map) / sizeof(struct mapping_s); j++) {
 			debug("%s, %s", p, map[j].name);
-			if(strncmp(p, map[j].name, strlen(map[j].name)) == 0) {
+			uint64_t n = strlen(map[j].name);
+			if(strncmp(p, map[j].name, n) == 0 && (n == l || p[n] == '.')) {
 				char name[l + 1];
 				memcpy(name, p, l); name[l] = '\0';
 				bench_function(&params, &map[j], name);
@@ -33,10 +33,12 @@ scalar_affine(
 	#define _e(_p, _i)		( (_p)[2 * bw + (_i)] )
 	#define _f(_p, _i)		( (_p)[4 * bw + (_i)] )
 	#define _vlen()			( 6 * bw )
-	uint8_t c[2 * bw + vec::LEN];
+
+	/* char buffer after maxpos_t, the vectors from the next cache line (see util.h) */
+	uint8_t *c = (uint8_t *)work + sizeof(maxpos_t);
 
 	/* init the leftmost vector (scalarically placed) */
-	uint16_t *base = (uint16_t *)((uint8_t *)work + sizeof(maxpos_t)), *curr = base, *prev = base;
+	uint16_t *base = (uint16_t *)((uint8_t *)work + arena_roundup(sizeof(maxpos_t) + 2 * bw + vec::LEN)), *curr = base, *prev = base;
 	#define _gap(_i)		( ((_i) > 0 ? gi : 0) + (_i) * ge )
 	for(uint64_t i = 0; i < 2 * bw; i++) {
 		if(i < bw) {
@@ -52,6 +54,7 @@ scalar_affine(
 	_f(curr, bw) = OFS + gi;
 	int32_t max = OFS;
 	uint64_t amax = 0, bmax = 0;					/* max score and its position */
+	uint64_t cmax = OFS, acnt = alen;				/* max of the center cells, #rows calculated */
 	for(uint64_t apos = 0; apos < alen; apos++) {
 		debug("apos(%llu)", apos);
 		int8_t ach = encode_a(a[apos]);
@@ -88,6 +91,11 @@ scalar_affine(
 
 		/* update maxpos */
 		debug("max(%d)", max - OFS);
+
+		/* X-drop test on the center (diagonal) cell, the same as the adaptive band */
+		uint64_t c = _s(curr, bw);
+		cmax = MAX2(cmax, c);
+		if(c + xt < cmax) { debug("xdrop"); acnt = apos + 1; break; }
 	}
 
 	/* save the maxpos */
@@ -97,7 +105,7 @@ scalar_affine(
 	r->apos = amax;
 	r->bpos = bmax;
 	#ifdef debug
-		r->ccnt = alen * 2 * bw;
+		r->ccnt = acnt * 2 * bw;
 		r->fcnt = 0;
 	#endif
 	return(max - OFS);
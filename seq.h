@@ -0,0 +1,189 @@
+
+/**
+ * @file seq.h
+ *
+ * @brief sequence views and reverse complement
+ *
+ * @detail
+ * The kernels take the two sequences through views instead of raw char
+ * pointers. A view maps a position to the encoded base, so that a kernel
+ * instantiated with rv_view extends to the left (from the tail to the head)
+ * and one with rc_view extends along the reverse-complemented strand,
+ * without copying nor reversing the sequence beforehand.
+ *
+ * fw_view: i-th base is p[i]
+ * rv_view: i-th base is p[len - 1 - i]
+ * rc_view: i-th base is complement of p[len - 1 - i]
+ * pk_view: i-th base is the i-th 2-bit field of the packed array p (4 bases per byte, LSb first)
+ * aa_view: i-th residue is p[i], encoded to the index of the score table of aa_matrix_t
+ * qv_view: i-th base is p[i], with the bin of its quality q[i] in bits 4 to 6 (qv_matrix_t)
+ */
+#ifndef _SEQ_H_INCLUDED
+#define _SEQ_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+#include <smmintrin.h>
+#include "util.h"
+
+/**
+ * @fn revcomp
+ * @brief in-place reverse complement of an ascii sequence. the complement is
+ * an xor picked by the lower nibble, exact on A, C, G, T, and N (and lowercase);
+ * other letters with the lower nibble of 1, 3, 4, or 7 are altered as well
+ * (W <-> S, D -> Q, ...).
+ */
+static inline
+void revcomp(char *seq, uint64_t len)
+{
+	/* xor mask indexed by the lower nibble: A <-> T (0x15), C <-> G (0x04) */
+	static int8_t const comp[16] __attribute__(( aligned(16) )) = {
+		0, 0x15, 0, 0x04, 0x15, 0, 0, 0x04, 0, 0, 0, 0, 0, 0, 0, 0
+	};
+	__m128i const cv = _mm_load_si128((__m128i const *)comp);
+	__m128i const rv = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__m128i const lv = _mm_set1_epi8(0x0f);
+	#define _rc(_v)		( _mm_shuffle_epi8(_mm_xor_si128((_v), _mm_shuffle_epi8(cv, _mm_and_si128((_v), lv))), rv) )
+
+	/* swap 16-byte blocks at the both ends */
+	char *p = seq, *q = seq + len;
+	while(q - p >= 32) {
+		q -= 16;
+		__m128i x = _mm_loadu_si128((__m128i const *)p);
+		__m128i y = _mm_loadu_si128((__m128i const *)q);
+		_mm_storeu_si128((__m128i *)p, _rc(y));
+		_mm_storeu_si128((__m128i *)q, _rc(x));
+		p += 16;
+	}
+	#undef _rc
+
+	/* the rest (shorter than 32 bases) */
+	#define _c(_x)		( (char)((_x) ^ comp[(_x) & 0x0f]) )
+	q--;
+	while(p < q) {
+		char t = *p;
+		*p++ = _c(*q);
+		*q-- = _c(t);
+	}
+	if(p == q) { *p = _c(*p); }
+	#undef _c
+	return;
+}
+
+/* internal linkage: compiled once per instruction set (see isa.h) */
+namespace {
+
+/**
+ * @struct fw_view
+ */
+struct fw_view {
+	char const *p;
+	uint64_t len;
+
+	fw_view(char const *_p, uint64_t _len) : p(_p), len(_len) {}
+
+	inline int8_t encode_a(uint64_t i) const { return(::encode_a(p[i])); }
+	inline int8_t encode_b(uint64_t i) const { return(::encode_b(p[i])); }
+	template<typename C>
+	inline C load_encode_b(uint64_t i) const {
+		C v; v.load_encode_b(&p[i], len - i);
+		return(v);
+	}
+};
+
+/**
+ * @struct rv_view
+ */
+struct rv_view {
+	char const *p;
+	uint64_t len;
+
+	rv_view(char const *_p, uint64_t _len) : p(_p), len(_len) {}
+
+	inline int8_t encode_a(uint64_t i) const { return(::encode_a(p[len - 1 - i])); }
+	inline int8_t encode_b(uint64_t i) const { return(::encode_b(p[len - 1 - i])); }
+	template<typename C>
+	inline C load_encode_b(uint64_t i) const {
+		C v; v.loadr_encode_b(&p[len - i], len - i, 0);
+		return(v);
+	}
+};
+
+/**
+ * @struct rc_view
+ */
+struct rc_view {
+	char const *p;
+	uint64_t len;
+
+	rc_view(char const *_p, uint64_t _len) : p(_p), len(_len) {}
+
+	inline int8_t encode_a(uint64_t i) const { return(0x03 ^ ::encode_a(p[len - 1 - i])); }
+	inline int8_t encode_b(uint64_t i) const { return(0x0c ^ ::encode_b(p[len - 1 - i])); }
+	template<typename C>
+	inline C load_encode_b(uint64_t i) const {
+		C v; v.loadr_encode_b(&p[len - i], len - i, 1);
+		return(v);
+	}
+};
+
+/**
+ * @struct pk_view
+ */
+struct pk_view {
+	uint8_t const *p;
+	uint64_t len;
+
+	pk_view(void const *_p, uint64_t _len) : p((uint8_t const *)_p), len(_len) {}
+
+	inline int8_t encode_a(uint64_t i) const { return(0x03 & (p[i>>2]>>(2*(i & 0x03)))); }
+	inline int8_t encode_b(uint64_t i) const { return(encode_a(i)<<2); }
+	template<typename C>
+	inline C load_encode_b(uint64_t i) const {
+		C v; v.loadp_encode_b(p, i, len - i);
+		return(v);
+	}
+};
+
+/**
+ * @struct aa_view
+ *
+ * @brief the same code for a and b; the kernels score it with the table of m
+ * instead of the 16-entry shuffle
+ */
+struct aa_view {
+	char const *p;
+	uint64_t len;
+	aa_matrix_t const *m;
+
+	aa_view(char const *_p, uint64_t _len, aa_matrix_t const *_m) : p(_p), len(_len), m(_m) {}
+
+	inline int8_t encode_a(uint64_t i) const { return(m->map[(uint8_t)p[i]]); }
+	inline int8_t encode_b(uint64_t i) const { return(m->map[(uint8_t)p[i]]); }
+};
+
+/**
+ * @struct qv_view
+ *
+ * @brief for a; the kernels score it with the table of its bin instead of the
+ * single 16-entry one
+ */
+struct qv_view {
+	char const *p;
+	uint8_t const *q;
+	uint64_t len;
+	qv_matrix_t const *m;
+
+	qv_view(char const *_p, uint8_t const *_q, uint64_t _len, qv_matrix_t const *_m) : p(_p), q(_q), len(_len), m(_m) {}
+
+	inline uint64_t bin(uint64_t i) const { return(m->bin[q[i]]); }
+	inline int8_t encode_a(uint64_t i) const { return(::encode_a(p[i]) | (bin(i)<<4)); }
+	inline int8_t encode_b(uint64_t i) const { return(::encode_b(p[i])); }
+};
+
+}	/* namespace */
+
+#endif /* #ifndef _SEQ_H_INCLUDED */
+/**
+ * end of seq.h
+ */
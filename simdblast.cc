@@ -5,7 +5,9 @@
  * @brief simd parallel blast_SemiGappedAlign algorithm
  */
 #include <string.h>
+#include "isa.h"
 #include "sse.h"
+#include "seq.h"
 /*
 #define DEBUG
 #include "log.h"
@@ -18,40 +20,61 @@
 #define OFS 	( 32768 )
 #define roundup(a, bound)		( (((a) + (bound) - 1) / (bound)) * (bound) )
 
+/* the row max is brought back to OFS once it exceeds REBASE_THRESH (see adaptive.cc) */
+#define REBASE_THRESH	( OFS + 16384 )
+
 /**
- * @fn simdblast_affine
+ * @fn row_table, table_min
+ *
+ * @brief the 16-entry table of row i (a base of a), and the min over the tables;
+ * on the qv view, the table of the quality bin of the base
+ */
+template<typename A>
+static inline
+int8_t const *row_table(A const &a, int8_t const *score_matrix, uint64_t i) { return(score_matrix); }
+static inline
+int8_t const *row_table(qv_view const &a, int8_t const *score_matrix, uint64_t i) { return(a.m->score[a.bin(i)]); }
+
+template<typename A>
+static inline
+int8_t table_min(A const &a, int8_t *score_matrix) { return(extract_min_score(score_matrix)); }
+static inline
+int8_t table_min(qv_view const &a, int8_t *score_matrix) { return(a.m->min); }
+
+/**
+ * @fn simdblast_affine_intl
+ *
+ * @brief a and b are sequence views (see seq.h); M is the gap model (see util.h),
+ * e and f are neither kept nor stored for linear gaps
  */
+template<typename T, int M, typename A, typename B>
+static inline
 int
-simdblast_affine(
+simdblast_affine_intl(
 	void *work,
-	char const *a,
-	uint64_t alen,
-	char const *b,
-	uint64_t blen,
-	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
-	uint32_t bw)		/* unused */
+	A const &a,
+	B const &b,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt)
 {
+	typedef vec_t<T> vec;
+	typedef char_vec_t<T> char_vec;
+
+	uint64_t const alen = a.len, blen = b.len;
 	if(alen == 0 || blen == 0) { return(0); }
-	debug("%s, %s", a, b);
-
-	vec const xtv(xt), zv, ofsv(OFS), smv((uint16_t const *)score_matrix);
-	vec const giv(-gi), gev(-ge), gev2(-2*ge), gev4(-4*ge), gev8(-8*ge);
-	int16_t const acc_ge[vec::LEN] __attribute__(( aligned(16) )) = {
-		(int16_t)(0),
-		(int16_t)(-ge),
-		(int16_t)(-2*ge),
-		(int16_t)(-3*ge),
-		(int16_t)(-4*ge),
-		(int16_t)(-5*ge),
-		(int16_t)(-6*ge),
-		(int16_t)(-7*ge)
-	};
-	vec acc_gev((uint16_t const *)acc_ge);
+	debug("%llu, %llu", alen, blen);
+	if(M == GAP_LINEAR) { gi = 0; }
+
+	vec const xtv(xt), zv, ofsv(OFS);
+	vec const giv(-gi), gev(-ge), gevl(-(int16_t)vec::LEN*ge);
+	int16_t acc_ge[vec::LEN] __attribute__(( aligned(vec::SIZE) ));
+	for(uint64_t i = 0; i < vec::LEN; i++) { acc_ge[i] = -(int16_t)i*ge; }
+	vec acc_gev((uint16_t const *)acc_ge), carry_gev = acc_gev + gev;
+	vec const scv_min(-table_min(a, score_matrix));
 	uint64_t vblen = roundup(blen, vec::LEN) / vec::LEN;
 	uint64_t first_b_index = 0, last_b_index = vblen;		/* [first_b_index, last_b_index) */
 
 	struct _dp {
-		uint16_t s[vec::LEN], e[vec::LEN], f[vec::LEN];
+		uint16_t s[vec::LEN], e[M == GAP_AFFINE ? vec::LEN : 0], f[M == GAP_AFFINE ? vec::LEN : 0];
 	};
 	struct _dp *ptr = (struct _dp *)work + sizeof(maxpos_t), *prev;
 	debug("%llu, %llu, %llu, %llu, %lu", alen, roundup((alen + 1), vec::LEN), roundup((alen + 1), vec::LEN) / vec::LEN + 1, blen, sizeof(struct _dp));
@@ -60,15 +83,19 @@ simdblast_affine(
 	vec init_pv = ofsv - giv - gev - acc_gev, init_ev = zv;
 	init_pv.print("init_pv");
 	init_pv.store(ptr[0].s);
-	init_ev.store(ptr[0].e);
-	init_pv.store(ptr[0].f);
+	if(M == GAP_AFFINE) {
+		init_ev.store(ptr[0].e);
+		init_pv.store(ptr[0].f);
+	}
 	for(uint64_t i = 0; i < vblen - 1; i++) {
-		init_pv -= gev8;
-		if((init_pv < ofsv - xtv) == 0xffff) { last_b_index = i + 1; }
+		init_pv -= gevl;
+		if((init_pv < ofsv - xtv) == vec::MASK) { last_b_index = i + 1; }
 		init_pv.print("init_pv");
 		init_pv.store(ptr[i + 1].s);
-		init_ev.store(ptr[i + 1].e);
-		init_pv.store(ptr[i + 1].f);
+		if(M == GAP_AFFINE) {
+			init_ev.store(ptr[i + 1].e);
+			init_pv.store(ptr[i + 1].f);
+		}
 	}
 	ptr[last_b_index].s[0] = OFS;
 	ptr[last_b_index].s[1] = last_b_index - first_b_index;
@@ -78,24 +105,25 @@ simdblast_affine(
 	vec max(OFS);
 	uint64_t amax = 0;
 	struct _dp *bmax = ptr + last_b_index;
+	uint64_t rbase = 0;						/* offset removed from the cells so far */
 	for(uint64_t a_index = 0; a_index < alen; a_index++) {
 		debug("a_index(%llu), ch(%c), b_range(%llu, %llu)", a_index, a[a_index], first_b_index, last_b_index);
 
 		prev = ptr; ptr += last_b_index + 1 - first_b_index;
-		char_vec av(encode_a(a[a_index]));
+		char_vec av(a.encode_a(a_index));
+		vec const smv(vec::table(row_table(a, score_matrix, a_index)));
 
 		#define _update_vector(_i) { \
-			char_vec bv; bv.load_encode_b(&b[(_i) * vec::LEN], blen - (_i) * vec::LEN); \
-			vec th(prev[_i].s), te(prev[_i].e); \
-			/* calc tentative s and e */ \
-			pe = vec::max(te, th - giv) - gev; \
-			pv = vec::max(th.dsl(ch) + smv.shuffle(av | bv), pe); ch = th; \
+			char_vec bv = b.template load_encode_b<char_vec>((_i) * vec::LEN); \
+			vec th(prev[_i].s); \
+			/* calc tentative s and e; e never exceeds s, so a linear e is s shifted */ \
+			pe = M == GAP_LINEAR ? th - gev : vec::max(vec(prev[_i].e), th - giv) - gev; \
+			/* clamped so that adding a negative score does not wrap around */ \
+			pv = vec::max(vec::max(th.dsl(ch), scv_min) + smv.shuffle(av | bv), pe); ch = th; \
 			av.print("av"); bv.print("bv"); smv.shuffle(av | bv).print("score"); \
-			/* calc f from the tentative s */ \
-			pf = vec::max(pv - giv, (pf>>7) - gev); \
-			pf = vec::max(pf, (pf<<1) - gev); \
-			pf = vec::max(pf, (pf<<2) - gev2); \
-			pf = vec::max(pf, (pf<<4) - gev4); \
+			/* calc f from the tentative s: scan within the vector first, then */ \
+			/* carry in the top cell of the previous one (off the scan chain) */ \
+			pf = vec::max((pv - giv).scan(-ge), pf.bcast_msb() - carry_gev); \
 			/* fixup s */ \
 			pv = vec::max(pv, pf); \
 			/* update max */ \
@@ -103,51 +131,60 @@ simdblast_affine(
 			pv.print("pv"); pe.print("pe"); pf.print("pf"); \
 		}
 
-		vec ch(OFS + _gap(a_index)), pv, pe, pf, mv(max[0]);
-		while(1) {
+		/* the leftmost column, clamped not to wrap around on long a */
+		int64_t const cl = (int64_t)OFS + _gap(a_index) - (int64_t)rbase;
+		vec ch((uint16_t)(cl < MIN ? MIN : cl)), pv, pe, pf, mv(max[0]);
+		while(first_b_index < last_b_index) {
 			_update_vector(first_b_index);
-			if((pv < max - xt) != 0xffff) { break; }
+			if((pv < max - xt) != vec::MASK) { break; }
 			first_b_index++; ptr--;
 		}
+		if(first_b_index == last_b_index) { break; }	/* the whole row dropped */
 
 		pv.store(ptr[first_b_index].s);
-		pe.store(ptr[first_b_index].e);
-		pf.store(ptr[first_b_index].f);
+		if(M == GAP_AFFINE) {
+			pe.store(ptr[first_b_index].e);
+			pf.store(ptr[first_b_index].f);
+		}
 
 		debug("ptr(%p), b_range(%llu, %llu)", ptr, first_b_index, last_b_index);
 		uint64_t next_last_b_index = last_b_index;
 		for(uint64_t b_index = first_b_index + 1; b_index < last_b_index; b_index++) {
 			_update_vector(b_index);
-			if((pv < max - xt) != 0xffff) { next_last_b_index = b_index + 1; }
+			if((pv < max - xt) != vec::MASK) { next_last_b_index = b_index + 1; }
 
 			pv.store(ptr[b_index].s);
-			pe.store(ptr[b_index].e);
-			pf.store(ptr[b_index].f);
+			if(M == GAP_AFFINE) {
+				pe.store(ptr[b_index].e);
+				pf.store(ptr[b_index].f);
+			}
 		}
 		last_b_index = next_last_b_index;
 		debug("updated b_range(%llu, %llu)", first_b_index, last_b_index);
 
 		if(last_b_index < vblen) {
-			char_vec bv; bv.load_encode_b(&b[last_b_index * vec::LEN], blen - last_b_index * vec::LEN);
-			vec d = gev8.dsl(ch) + smv.shuffle(av | bv);
+			char_vec bv = b.template load_encode_b<char_vec>(last_b_index * vec::LEN);
+			vec d = vec::max(gevl.dsl(ch), scv_min) + smv.shuffle(av | bv);
 			mv = vec::max(mv, d);
 
-			pf = vec::max(d - giv, (pf>>7) - gev);
+			pf = vec::max(d - giv, (pf>>(vec::LEN - 1)) - gev);
 			pf.set(pf[0]); pf -= acc_gev;
 			pv = vec::max(d, pf);
 			while(last_b_index < vblen) {
-				if((pv < max - xt) == 0xffff) { break; }
+				if((pv < max - xt) == vec::MASK) { break; }
 
 				pv.print("pv (tail)");
 				pf.print("pf (tail)");
 
 				pv.store(ptr[last_b_index].s);
-				zv.store(ptr[last_b_index].e);
-				pf.store(ptr[last_b_index].f);
+				if(M == GAP_AFFINE) {
+					zv.store(ptr[last_b_index].e);
+					pf.store(ptr[last_b_index].f);
+				}
 				last_b_index++;
 
-				pv -= gev8;
-				pf -= gev8;
+				pv -= gevl;
+				pf -= gevl;
 			}
 		}
 
@@ -155,6 +192,23 @@ simdblast_affine(
 		if(m > max[0]) { amax = a_index + 1; bmax = ptr + last_b_index; }
 		max.set(m);
 
+		/* rebase the row; the next one is calculated from this one only */
+		if(m > REBASE_THRESH) {
+			debug("rebase(%d)", m - OFS);
+			vec const dv((uint16_t)(m - OFS));
+			for(uint64_t b_index = first_b_index; b_index < last_b_index; b_index++) {
+				vec ts(ptr[b_index].s);
+				(ts - dv).store(ptr[b_index].s);
+				if(M == GAP_AFFINE) {
+					vec te(ptr[b_index].e), tf(ptr[b_index].f);
+					(te - dv).store(ptr[b_index].e);
+					(tf - dv).store(ptr[b_index].f);
+				}
+			}
+			rbase += m - OFS;
+			max.set(m = OFS);
+		}
+
 		ptr[last_b_index].s[0] = m;
 		ptr[last_b_index].s[1] = last_b_index - first_b_index;
 		ptr[last_b_index].s[2] = first_b_index;
@@ -167,16 +221,124 @@ simdblast_affine(
 	r->apos = 0;
 	r->bpos = 0;
 	struct _dp *bbase = bmax - bmax->s[1];
+	vec const smax((uint16_t)(bmax->s[0]));		/* the max as stored, rebased along with the row */
 	for(uint64_t b_index = 0; b_index < bmax->s[1]; b_index++) {
 		vec pv(bbase[b_index].s);
 		pv.print("pv (search)");
-		if(pv == max) {
+		if(pv == smax) {
 			r->apos = amax;
-			r->bpos = vec::LEN * (bmax->s[2] + b_index) + (tzcnt(pv == max)>>1) + 1;
+			r->bpos = vec::LEN * (bmax->s[2] + b_index) + (tzcnt(pv == smax)>>1) + 1;
 			break;
 		}
 	}
-	return(max[0] - OFS);
+	return((int64_t)max[0] - OFS + rbase);
+}
+
+/**
+ * @fn simdblast_affine
+ */
+int
+_isa(simdblast_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(simdblast_affine_intl<isa_t, GAP_AFFINE>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt));
+}
+
+/**
+ * @fn simdblast_qv
+ *
+ * @brief quality-aware scoring: the table of qv (util.h) picked by the quality
+ * in qa of each base of a, switched per row
+ */
+int
+_isa(simdblast_qv)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	qv_matrix_t const *qv, uint8_t const *qa, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(simdblast_affine_intl<isa_t, GAP_AFFINE>(work, qv_view(a, qa, alen, qv), fw_view(b, blen), (int8_t *)qv->score[0], gi, ge, xt));
+}
+
+/**
+ * @fn simdblast_linear
+ *
+ * @brief linear gap (ge per base, gi ignored)
+ */
+int
+_isa(simdblast_linear)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(simdblast_affine_intl<isa_t, GAP_LINEAR>(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt));
+}
+
+/**
+ * @fn simdblast_rv_affine
+ *
+ * @brief extends leftward from the tails of a and b
+ */
+int
+_isa(simdblast_rv_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(simdblast_affine_intl<isa_t, GAP_AFFINE>(work, rv_view(a, alen), rv_view(b, blen), score_matrix, gi, ge, xt));
+}
+
+/**
+ * @fn simdblast_rc_affine
+ *
+ * @brief aligns a to the reverse complement of b
+ */
+int
+_isa(simdblast_rc_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(simdblast_affine_intl<isa_t, GAP_AFFINE>(work, fw_view(a, alen), rc_view(b, blen), score_matrix, gi, ge, xt));
+}
+
+/**
+ * @fn simdblast_pk_affine
+ *
+ * @brief a and b are 2-bit packed arrays (4 bases per byte, LSb first)
+ */
+int
+_isa(simdblast_pk_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* unused */
+{
+	return(simdblast_affine_intl<isa_t, GAP_AFFINE>(work, pk_view(a, alen), pk_view(b, blen), score_matrix, gi, ge, xt));
 }
 
 #ifdef MAIN
@@ -204,7 +366,7 @@ int main_ext(int argc, char *argv[])
 		printf("./a.out AAA AAA 2 -3 -5 -1 30\n");
 	}
 
-	int score = simdblast_affine(
+	int score = _isa(simdblast_affine)(
 		work,
 		a, alen, b, blen,
 		score_matrix,
@@ -232,7 +394,7 @@ int main(int argc, char *argv[])
 	void *work = aligned_malloc(128 * 1024 * 1024, 16);
 
 	#define a(s, p, q) { \
-		assert(simdblast_affine(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10) == (s)); \
+		assert(_isa(simdblast_affine)(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10) == (s)); \
 	}
 	a( 0, "", "");
 	a( 0, "A", "");
@@ -244,7 +406,7 @@ int main(int argc, char *argv[])
 	a( 4, "AAACAAAGGG", "AAAAAATTTTTTT");
 	a( 3, "AAACCAAAGGG", "AAAAAATTTTTTT");
 
-	int sa = simdblast_affine(work, a, strlen(a), b, strlen(b), score_matrix, -1, -1, 30);
+	int sa = _isa(simdblast_affine)(work, a, strlen(a), b, strlen(b), score_matrix, -1, -1, 30);
 	printf("%d\n", sa);
 
 	free(work);
@@ -3,153 +3,581 @@
  * @file sse.h
  *
  * @brief class implementation
+ *
+ * @detail
+ * vec_t and char_vec_t are thin wrappers of the instruction-set traits
+ * below. The traits provide the register types and the primitive
+ * operations; the classes provide the operators the kernels use, so that a
+ * kernel written on vec_t<T> compiles for every T. vec and char_vec are the
+ * instances for the widest instruction set enabled by the compiler flags.
+ *
+ * sse41_t:  8 x 16-bit cells in __m128i, 8 x 8-bit chars in uint64_t
+ * avx2_t:   16 x 16-bit cells in __m256i, 16 x 8-bit chars in __m128i
+ * avx512_t: 32 x 16-bit cells in __m512i, 32 x 8-bit chars in __m256i (AVX-512BW)
+ *
+ * Comparisons return a mask with two bits per cell (as pmovmskb on 16-bit
+ * cells); vec_t<T>::MASK is the mask of all the cells.
  */
 #ifndef _SSE_H_INCLUDED
 #define _SSE_H_INCLUDED
 
 #include <smmintrin.h>
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
-#define DEBUG2
+/* internal linkage: compiled once per instruction set (see isa.h) */
+namespace {
 
 /**
- * @class char_vec
+ * @struct sse41_t
+ *
+ * @brief SSE4.1 16bit 8cell
  */
-typedef uint64_t char_vec_reg;
+struct sse41_t {
+	typedef __m128i reg;
+	typedef uint64_t creg;
+
+	/* cells */
+	static inline reg zero(void) { return(_mm_setzero_si128()); }
+	static inline reg set1(int16_t k) { return(_mm_set1_epi16(k)); }
+	static inline reg load(void const *p) { return(_mm_load_si128((__m128i const *)p)); }
+	static inline reg loadu(void const *p) { return(_mm_loadu_si128((__m128i const *)p)); }
+	static inline void store(void *p, reg v) { _mm_store_si128((__m128i *)p, v); }
+	static inline void storeu(void *p, reg v) { _mm_storeu_si128((__m128i *)p, v); }
+	/* 16-entry byte table for shuffle */
+	static inline reg table(void const *p) { return(_mm_loadu_si128((__m128i const *)p)); }
+
+	static inline reg add(reg a, reg b) { return(_mm_add_epi16(a, b)); }
+	static inline reg subs(reg a, reg b) { return(_mm_subs_epu16(a, b)); }
+	static inline reg and_(reg a, reg b) { return(_mm_and_si128(a, b)); }
+	static inline reg or_(reg a, reg b) { return(_mm_or_si128(a, b)); }
+	static inline reg max(reg a, reg b) { return(_mm_max_epu16(a, b)); }
+	static inline reg cmpeq(reg a, reg b) { return(_mm_cmpeq_epi16(a, b)); }
+	static inline reg blend(reg x, reg m, reg mask) { return(_mm_blendv_epi8(x, m, mask)); }
+	static inline uint64_t mask(reg v) { return((uint16_t)_mm_movemask_epi8(v)); }
+	static inline uint64_t eq(reg a, reg b) { return(mask(cmpeq(a, b))); }
+	static inline uint64_t gt(reg a, reg b) {
+		reg const ofs = set1(32768);
+		return(mask(_mm_cmpgt_epi16(_mm_sub_epi16(a, ofs), _mm_sub_epi16(b, ofs))));
+	}
+
+	static inline reg shl(reg v, int s) {
+		switch(s) {
+		#define l(n) c(n+1) c(n+2) c(n+3) c(n+4) c(n+5) c(n+6) c(n+7)
+			case 0: return(v);
+		#define c(n) case n: return(_mm_slli_si128(v, 2*(n)));
+			l(0);
+		#undef c
+			default: return(zero());
+		#undef l
+		}
+	}
+	static inline reg shr(reg v, int s) {
+		switch(s) {
+		#define l(n) c(n+1) c(n+2) c(n+3) c(n+4) c(n+5) c(n+6) c(n+7)
+			case 0: return(v);
+		#define c(n) case n: return(_mm_srli_si128(v, 2*(n)));
+			l(0);
+		#undef c
+			default: return(zero());
+		#undef l
+		}
+	}
+	/* (a<<7) | (b>>1) */
+	static inline reg dsr(reg a, reg b) { return(_mm_alignr_epi8(a, b, 2)); }
+	/* (a<<1) | (b>>7) */
+	static inline reg dsl(reg a, reg b) { return(_mm_alignr_epi8(a, b, 14)); }
+	/* the top cell in all the cells */
+	static inline reg bcast_msb(reg v) { return(_mm_shuffle_epi8(v, set1(0x0f0e))); }
+	/* v[i] = max(v[j] - (i - j) * ge) over j <= i, in log2(8) steps */
+	static inline reg scan(reg v, uint16_t ge) {
+		v = max(v, subs(_mm_slli_si128(v, 2), set1(ge)));
+		v = max(v, subs(_mm_slli_si128(v, 4), set1(2*ge)));
+		v = max(v, subs(_mm_slli_si128(v, 8), set1(4*ge)));
+		return(v);
+	}
+
+	static inline reg shuffle(reg t, creg i) {
+		return(_mm_cvtepi8_epi16(_mm_shuffle_epi8(t, _mm_cvtsi64_si128(i))));
+	}
+	/* t[(a & 0x3f) * 64 + (b & 0x3f)] for each cell, sign-extended (the 64 x 64 protein table) */
+	static inline reg gather(int8_t const *t, creg a, creg b) {
+		int16_t s[8];
+		for(uint64_t i = 0; i < 8; i++) {
+			s[i] = t[(((a>>(8*i)) & 0x3f)<<6) | ((b>>(8*i)) & 0x3f)];
+		}
+		return(loadu(s));
+	}
+	static inline uint16_t hmax(reg v) {
+		reg t = _mm_max_epu16(v, _mm_srli_si128(v, 2));
+		t = _mm_max_epu16(t, _mm_srli_si128(t, 4));
+		t = _mm_max_epu16(t, _mm_srli_si128(t, 8));
+		return((uint16_t)_mm_extract_epi16(t, 0));
+	}
+	static inline uint16_t extract(reg v, uint64_t i) {
+		switch(i) {
+			case 0: return((uint16_t)_mm_extract_epi16(v, 0));
+			case 1: return((uint16_t)_mm_extract_epi16(v, 1));
+			case 2: return((uint16_t)_mm_extract_epi16(v, 2));
+			case 3: return((uint16_t)_mm_extract_epi16(v, 3));
+			case 4: return((uint16_t)_mm_extract_epi16(v, 4));
+			case 5: return((uint16_t)_mm_extract_epi16(v, 5));
+			case 6: return((uint16_t)_mm_extract_epi16(v, 6));
+			case 7: return((uint16_t)_mm_extract_epi16(v, 7));
+			default: return(0);
+		}
+	}
 
-class char_vec {
+	/* chars */
+	static inline creg cset1(int8_t k) { return(0x0101010101010101 * (uint8_t)k); }
+	static inline creg cload(void const *p) { creg v; memcpy(&v, p, sizeof(creg)); return(v); }
+	static inline void cstore(void *p, creg v) { memcpy(p, &v, sizeof(creg)); }
+	static inline creg cand(creg a, creg b) { return(a & b); }
+	static inline creg cor(creg a, creg b) { return(a | b); }
+	static inline creg cxor(creg a, creg b) { return(a ^ b); }
+	static inline creg cadds(creg a, creg b) { return(_mm_cvtsi128_si64(_mm_adds_epu8(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b)))); }
+	static inline creg cdsr(creg a, creg b) { return((a<<56) | (b>>8)); }
+	static inline creg cdsl(creg a, creg b) { return((a<<8) | (b>>56)); }
+	static inline creg creverse(creg v) { return(__builtin_bswap64(v)); }
+	static inline int8_t cextract(creg v, uint64_t i) { return(i < 8 ? (v>>(8*i)) & 0xff : 0); }
+	static inline creg cencode_a(creg v) { return(0x0303030303030303 & ((v>>1) ^ (v>>2))); }
+	static inline creg cencode_b(creg v, uint64_t comp) {
+		uint64_t const m = 0x0c0c0c0c0c0c0c0c;
+		return((m & ((v<<1) ^ v)) ^ (comp ? m : 0));
+	}
+	/* lanes at and beyond len are replaced with encode_n() */
+	static inline creg cpad(creg v, uint64_t len) {
+		uint64_t const m = len >= 8 ? ~0ULL : (1ULL<<(8*len)) - 1;
+		return((v & m) | (0x0909090909090909 & ~m));
+	}
+};
+
+#if defined(__AVX2__)
+/**
+ * @struct avx2_t
+ *
+ * @brief AVX2 16bit 16cell
+ */
+struct avx2_t {
+	typedef __m256i reg;
+	typedef __m128i creg;
+
+	/* cells */
+	static inline reg zero(void) { return(_mm256_setzero_si256()); }
+	static inline reg set1(int16_t k) { return(_mm256_set1_epi16(k)); }
+	static inline reg load(void const *p) { return(_mm256_load_si256((__m256i const *)p)); }
+	static inline reg loadu(void const *p) { return(_mm256_loadu_si256((__m256i const *)p)); }
+	static inline void store(void *p, reg v) { _mm256_store_si256((__m256i *)p, v); }
+	static inline void storeu(void *p, reg v) { _mm256_storeu_si256((__m256i *)p, v); }
+	static inline reg table(void const *p) {
+		return(_mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)p)));
+	}
+
+	static inline reg add(reg a, reg b) { return(_mm256_add_epi16(a, b)); }
+	static inline reg subs(reg a, reg b) { return(_mm256_subs_epu16(a, b)); }
+	static inline reg and_(reg a, reg b) { return(_mm256_and_si256(a, b)); }
+	static inline reg or_(reg a, reg b) { return(_mm256_or_si256(a, b)); }
+	static inline reg max(reg a, reg b) { return(_mm256_max_epu16(a, b)); }
+	static inline reg cmpeq(reg a, reg b) { return(_mm256_cmpeq_epi16(a, b)); }
+	static inline reg blend(reg x, reg m, reg mask) { return(_mm256_blendv_epi8(x, m, mask)); }
+	static inline uint64_t mask(reg v) { return((uint32_t)_mm256_movemask_epi8(v)); }
+	static inline uint64_t eq(reg a, reg b) { return(mask(cmpeq(a, b))); }
+	static inline uint64_t gt(reg a, reg b) {
+		reg const ofs = set1(32768);
+		return(mask(_mm256_cmpgt_epi16(_mm256_sub_epi16(a, ofs), _mm256_sub_epi16(b, ofs))));
+	}
+
+	/* lane-crossing shifts: the 128-bit halves are first moved by permute2x128 */
+	static inline reg shl(reg v, int s) {
+		reg const t = _mm256_permute2x128_si256(v, v, 0x08);		/* v.lo in the upper half */
+		switch(s) {
+			case 0: return(v);
+		#define c(n) case n: return(_mm256_alignr_epi8(v, t, 16 - 2*(n)));
+			c(1) c(2) c(3) c(4) c(5) c(6) c(7)
+		#undef c
+		#define c(n) case n: return(_mm256_slli_si256(t, 2*((n) - 8)));
+			c(8) c(9) c(10) c(11) c(12) c(13) c(14) c(15)
+		#undef c
+			default: return(zero());
+		}
+	}
+	static inline reg shr(reg v, int s) {
+		reg const t = _mm256_permute2x128_si256(v, v, 0x81);		/* v.hi in the lower half */
+		switch(s) {
+			case 0: return(v);
+		#define c(n) case n: return(_mm256_alignr_epi8(t, v, 2*(n)));
+			c(1) c(2) c(3) c(4) c(5) c(6) c(7)
+		#undef c
+		#define c(n) case n: return(_mm256_srli_si256(t, 2*((n) - 8)));
+			c(8) c(9) c(10) c(11) c(12) c(13) c(14) c(15)
+		#undef c
+			default: return(zero());
+		}
+	}
+	/* (a<<15) | (b>>1) */
+	static inline reg dsr(reg a, reg b) {
+		return(_mm256_alignr_epi8(_mm256_permute2x128_si256(b, a, 0x21), b, 2));
+	}
+	/* (a<<1) | (b>>15) */
+	static inline reg dsl(reg a, reg b) {
+		return(_mm256_alignr_epi8(a, _mm256_permute2x128_si256(b, a, 0x21), 14));
+	}
+	static inline reg bcast_msb(reg v) {
+		return(_mm256_shuffle_epi8(_mm256_permute4x64_epi64(v, 0xff), set1(0x0706)));
+	}
+	/*
+	 * three in-lane steps, then the top cell of the lower half is carried
+	 * into the upper half at once, instead of four lane-crossing shifts
+	 */
+	static inline reg scan(reg v, uint16_t ge) {
+		v = max(v, subs(_mm256_slli_si256(v, 2), set1(ge)));
+		v = max(v, subs(_mm256_slli_si256(v, 4), set1(2*ge)));
+		v = max(v, subs(_mm256_slli_si256(v, 8), set1(4*ge)));
+		reg const ramp = _mm256_mullo_epi16(set1(ge),
+			_mm256_setr_epi16(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8));
+		reg const t = _mm256_shuffle_epi8(_mm256_permute2x128_si256(v, v, 0x08), set1(0x0f0e));
+		return(max(v, subs(t, ramp)));
+	}
+
+	static inline reg shuffle(reg t, creg i) {
+		return(_mm256_cvtepi8_epi16(_mm_shuffle_epi8(_mm256_castsi256_si128(t), i)));
+	}
+	/* two 8-lane dword gathers at byte offsets, packed back to the cell order */
+	static inline reg gidx(__m128i a, __m128i b) {
+		reg const m = _mm256_set1_epi32(0x3f);
+		return(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_cvtepu8_epi32(a), m), 6),
+			_mm256_and_si256(_mm256_cvtepu8_epi32(b), m)));
+	}
+	static inline reg gather(int8_t const *t, creg a, creg b) {
+		reg lo = _mm256_i32gather_epi32((int const *)t, gidx(a, b), 1);
+		reg hi = _mm256_i32gather_epi32((int const *)t, gidx(_mm_srli_si128(a, 8), _mm_srli_si128(b, 8)), 1);
+		lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 24), 24);
+		hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 24), 24);
+		return(_mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xd8));
+	}
+	static inline uint16_t hmax(reg v) {
+		return(sse41_t::hmax(_mm_max_epu16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))));
+	}
+	static inline uint16_t extract(reg v, uint64_t i) {
+		uint16_t b[16] __attribute__(( aligned(32) ));
+		store(b, v);
+		return(i < 16 ? b[i] : 0);
+	}
+
+	/* chars */
+	static inline creg ciota(void) { return(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)); }
+	static inline creg cset1(int8_t k) { return(_mm_set1_epi8(k)); }
+	static inline creg cload(void const *p) { return(_mm_loadu_si128((__m128i const *)p)); }
+	static inline void cstore(void *p, creg v) { _mm_storeu_si128((__m128i *)p, v); }
+	static inline creg cand(creg a, creg b) { return(_mm_and_si128(a, b)); }
+	static inline creg cor(creg a, creg b) { return(_mm_or_si128(a, b)); }
+	static inline creg cxor(creg a, creg b) { return(_mm_xor_si128(a, b)); }
+	static inline creg cadds(creg a, creg b) { return(_mm_adds_epu8(a, b)); }
+	static inline creg cdsr(creg a, creg b) { return(_mm_alignr_epi8(a, b, 1)); }
+	static inline creg cdsl(creg a, creg b) { return(_mm_alignr_epi8(a, b, 15)); }
+	static inline creg creverse(creg v) {
+		return(_mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)));
+	}
+	static inline int8_t cextract(creg v, uint64_t i) {
+		int8_t b[16]; cstore(b, v);
+		return(i < 16 ? b[i] : 0);
+	}
+	static inline creg cencode_a(creg v) {
+		return(_mm_and_si128(_mm_set1_epi8(0x03), _mm_xor_si128(_mm_srli_epi16(v, 1), _mm_srli_epi16(v, 2))));
+	}
+	static inline creg cencode_b(creg v, uint64_t comp) {
+		creg const m = _mm_set1_epi8(0x0c);
+		v = _mm_and_si128(m, _mm_xor_si128(_mm_add_epi8(v, v), v));
+		return(comp ? _mm_xor_si128(v, m) : v);
+	}
+	static inline creg cpad(creg v, uint64_t len) {
+		creg const m = _mm_cmpgt_epi8(_mm_set1_epi8(len > 16 ? 16 : len), ciota());
+		return(_mm_blendv_epi8(_mm_set1_epi8(0x09), v, m));
+	}
+};
+#endif /* __AVX2__ */
+
+#if defined(__AVX512BW__)
+/*
+ * the AVX-512 intrinsics of gcc 12.2 and older pass _mm512_undefined_epi32()
+ * as the merge source of their unmasked builtins, which the uninitialized
+ * checks flag once the helpers below are inlined (gcc PR 105593)
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/**
+ * @struct avx512_t
+ *
+ * @brief AVX-512BW 16bit 32cell
+ */
+struct avx512_t {
+	typedef __m512i reg;
+	typedef __m256i creg;
+
+	/* cells */
+	static inline reg zero(void) { return(_mm512_setzero_si512()); }
+	static inline reg set1(int16_t k) { return(_mm512_set1_epi16(k)); }
+	static inline reg load(void const *p) { return(_mm512_load_si512(p)); }
+	static inline reg loadu(void const *p) { return(_mm512_loadu_si512(p)); }
+	static inline void store(void *p, reg v) { _mm512_store_si512(p, v); }
+	static inline void storeu(void *p, reg v) { _mm512_storeu_si512(p, v); }
+	static inline reg table(void const *p) {
+		return(_mm512_broadcast_i32x4(_mm_loadu_si128((__m128i const *)p)));
+	}
+
+	static inline reg add(reg a, reg b) { return(_mm512_add_epi16(a, b)); }
+	static inline reg subs(reg a, reg b) { return(_mm512_subs_epu16(a, b)); }
+	static inline reg and_(reg a, reg b) { return(_mm512_and_si512(a, b)); }
+	static inline reg or_(reg a, reg b) { return(_mm512_or_si512(a, b)); }
+	static inline reg max(reg a, reg b) { return(_mm512_max_epu16(a, b)); }
+	static inline reg cmpeq(reg a, reg b) { return(_mm512_movm_epi16(_mm512_cmpeq_epi16_mask(a, b))); }
+	static inline reg blend(reg x, reg m, reg mask) {
+		return(_mm512_mask_blend_epi16(_mm512_movepi16_mask(mask), x, m));
+	}
+	static inline uint64_t mask(reg v) { return(_mm512_movepi8_mask(v)); }
+	/* mask registers hold one bit per cell; widened to two bits to match the others */
+	static inline uint64_t widen(__mmask32 m) { return(_mm512_movepi8_mask(_mm512_movm_epi16(m))); }
+	static inline uint64_t eq(reg a, reg b) { return(widen(_mm512_cmpeq_epi16_mask(a, b))); }
+	static inline uint64_t gt(reg a, reg b) { return(widen(_mm512_cmpgt_epu16_mask(a, b))); }
+
+	/* vpermw moves cells across the 128-bit lanes in one instruction */
+	static inline reg iota(void) {
+		return(_mm512_set_epi16(
+			31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16,
+			15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+	}
+	static inline reg shl(reg v, int s) {
+		if(s <= 0) { return(v); }
+		if(s >= 32) { return(zero()); }
+		return(_mm512_maskz_permutexvar_epi16((__mmask32)(0xffffffff<<s), _mm512_sub_epi16(iota(), set1(s)), v));
+	}
+	static inline reg shr(reg v, int s) {
+		if(s <= 0) { return(v); }
+		if(s >= 32) { return(zero()); }
+		return(_mm512_maskz_permutexvar_epi16((__mmask32)(0xffffffff>>s), _mm512_add_epi16(iota(), set1(s)), v));
+	}
+	/* (a<<31) | (b>>1): index 32 and above selects a */
+	static inline reg dsr(reg a, reg b) {
+		return(_mm512_permutex2var_epi16(b, _mm512_add_epi16(iota(), set1(1)), a));
+	}
+	/* (a<<1) | (b>>31) */
+	static inline reg dsl(reg a, reg b) {
+		return(_mm512_permutex2var_epi16(b, _mm512_add_epi16(iota(), set1(31)), a));
+	}
+	static inline reg bcast_msb(reg v) { return(_mm512_permutexvar_epi16(set1(31), v)); }
+	static inline reg scan(reg v, uint16_t ge) {
+		for(int s = 1; s < 32; s <<= 1) {
+			v = max(v, subs(shl(v, s), set1(s*ge)));
+		}
+		return(v);
+	}
+
+	static inline reg shuffle(reg t, creg i) {
+		return(_mm512_cvtepi8_epi16(_mm256_shuffle_epi8(_mm512_castsi512_si256(t), i)));
+	}
+	/* two 16-lane dword gathers at byte offsets, narrowed with vpmovdw */
+	static inline reg gidx(__m128i a, __m128i b) {
+		reg const m = _mm512_set1_epi32(0x3f);
+		return(_mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(_mm512_cvtepu8_epi32(a), m), 6),
+			_mm512_and_si512(_mm512_cvtepu8_epi32(b), m)));
+	}
+	static inline reg gather(int8_t const *t, creg a, creg b) {
+		reg lo = _mm512_i32gather_epi32(gidx(_mm256_castsi256_si128(a), _mm256_castsi256_si128(b)), t, 1);
+		reg hi = _mm512_i32gather_epi32(gidx(_mm256_extracti128_si256(a, 1), _mm256_extracti128_si256(b, 1)), t, 1);
+		lo = _mm512_srai_epi32(_mm512_slli_epi32(lo, 24), 24);
+		hi = _mm512_srai_epi32(_mm512_slli_epi32(hi, 24), 24);
+		return(_mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi32_epi16(lo)), _mm512_cvtepi32_epi16(hi), 1));
+	}
+	static inline uint16_t hmax(reg v) {
+		return(avx2_t::hmax(_mm256_max_epu16(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1))));
+	}
+	static inline uint16_t extract(reg v, uint64_t i) {
+		uint16_t b[32] __attribute__(( aligned(64) ));
+		store(b, v);
+		return(i < 32 ? b[i] : 0);
+	}
+
+	/* chars */
+	static inline creg ciota(void) {
+		return(_mm256_setr_epi8(
+			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+			16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31));
+	}
+	static inline creg cset1(int8_t k) { return(_mm256_set1_epi8(k)); }
+	static inline creg cload(void const *p) { return(_mm256_loadu_si256((__m256i const *)p)); }
+	static inline void cstore(void *p, creg v) { _mm256_storeu_si256((__m256i *)p, v); }
+	static inline creg cand(creg a, creg b) { return(_mm256_and_si256(a, b)); }
+	static inline creg cor(creg a, creg b) { return(_mm256_or_si256(a, b)); }
+	static inline creg cxor(creg a, creg b) { return(_mm256_xor_si256(a, b)); }
+	static inline creg cadds(creg a, creg b) { return(_mm256_adds_epu8(a, b)); }
+	static inline creg cdsr(creg a, creg b) {
+		return(_mm256_alignr_epi8(_mm256_permute2x128_si256(b, a, 0x21), b, 1));
+	}
+	static inline creg cdsl(creg a, creg b) {
+		return(_mm256_alignr_epi8(a, _mm256_permute2x128_si256(b, a, 0x21), 15));
+	}
+	static inline creg creverse(creg v) {
+		creg const r = _mm256_setr_epi8(
+			15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+			15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+		return(_mm256_shuffle_epi8(_mm256_permute4x64_epi64(v, 0x4e), r));
+	}
+	static inline int8_t cextract(creg v, uint64_t i) {
+		int8_t b[32]; cstore(b, v);
+		return(i < 32 ? b[i] : 0);
+	}
+	static inline creg cencode_a(creg v) {
+		return(_mm256_and_si256(_mm256_set1_epi8(0x03), _mm256_xor_si256(_mm256_srli_epi16(v, 1), _mm256_srli_epi16(v, 2))));
+	}
+	static inline creg cencode_b(creg v, uint64_t comp) {
+		creg const m = _mm256_set1_epi8(0x0c);
+		v = _mm256_and_si256(m, _mm256_xor_si256(_mm256_add_epi8(v, v), v));
+		return(comp ? _mm256_xor_si256(v, m) : v);
+	}
+	static inline creg cpad(creg v, uint64_t len) {
+		creg const m = _mm256_cmpgt_epi8(_mm256_set1_epi8(len > 32 ? 32 : len), ciota());
+		return(_mm256_blendv_epi8(_mm256_set1_epi8(0x09), v, m));
+	}
+};
+
+#pragma GCC diagnostic pop
+#endif /* __AVX512BW__ */
+
+/**
+ * @class char_vec_t
+ */
+template<typename T>
+class char_vec_t {
 
 private:
-	uint64_t v;
+	typedef typename T::creg creg;
+	creg v;
 
 public:
 	/* consts */
 	static int8_t const MAX = 127;
 	static int8_t const MIN = -128;
-	static uint64_t const SIZE = sizeof(uint64_t);
-	static uint64_t const LEN = sizeof(uint64_t);
+	static uint64_t const SIZE = sizeof(creg);
+	static uint64_t const LEN = sizeof(creg);
 
 	/* constructors */
-	char_vec(void) {
+	char_vec_t(void) {
 		set(0);
 	}
-	char_vec(int8_t k) {
+	char_vec_t(int8_t k) {
 		set(k);
 	}
-	char_vec(uint64_t i) {
+	char_vec_t(creg i) {
 		v = i;
 	}
-	char_vec(uint64_t const *p) {
-		v = *p;
-	}
-	char_vec(int8_t const *p) {
-		v = *((uint64_t *)p);
+	char_vec_t(int8_t const *p) {
+		load(p);
 	}
 
 	/* setter */
 	inline void zero(void) {
-		v = 0;
+		v = T::cset1(0);
 	}
 	inline void set(int8_t k) {
-		v = ((uint64_t)k<<8) | (uint64_t)k;
-		v = (v<<16) | v;
-		v = (v<<32) | v;
+		v = T::cset1(k);
 	}
 
 	/* getter */
-	inline uint64_t const &get(void) const { return(v); }
+	inline creg const &get(void) const { return(v); }
 
 	/* assign */
-	inline char_vec operator=(char_vec const &b) {
-		return(char_vec(v = b.get()));
+	inline char_vec_t operator=(char_vec_t const &b) {
+		return(char_vec_t(v = b.get()));
 	}
 
 	/* and */
-	inline char_vec operator&(char_vec const &b) const {
-		return(char_vec(v & b.get()));
+	inline char_vec_t operator&(char_vec_t const &b) const {
+		return(char_vec_t(T::cand(v, b.get())));
 	}
 	/* or */
-	inline char_vec operator|(char_vec const &b) const {
-		return(char_vec(v | b.get()));
+	inline char_vec_t operator|(char_vec_t const &b) const {
+		return(char_vec_t(T::cor(v, b.get())));
 	}
-	/* shift left */
-	inline char_vec operator<<(int s) const {
-		switch(s) {
-		#define l(n) c(n+1) c(n+2) c(n+3) c(n+4) c(n+5) c(n+6) c(n+7)
-			case 0: return(char_vec(v));
-		#define c(n) case n: return(char_vec(v<<(8*(n))));
-			l(0);
-		#undef c
-			default: return(char_vec((uint64_t)0));
-		#undef l
-		}
+	/* xor */
+	inline char_vec_t operator^(char_vec_t const &b) const {
+		return(char_vec_t(T::cxor(v, b.get())));
 	}
-	inline char_vec operator>>(int s) const {
-		switch(s) {
-		#define l(n) c(n+1) c(n+2) c(n+3) c(n+4) c(n+5) c(n+6) c(n+7)
-			case 0: return(char_vec(v));
-		#define c(n) case n: return(char_vec(v>>(8*(n))));
-			l(0);
-		#undef c
-			default: return(char_vec((uint64_t)0));
-		#undef l
-		}
+	/* unsigned saturating add */
+	inline char_vec_t adds(char_vec_t const &b) const {
+		return(char_vec_t(T::cadds(v, b.get())));
 	}
-	/* double shift: (a<<7) | (b>>1) */
-	inline char_vec dsr(char_vec const &b) const {
-		return(char_vec((v<<56) | (b.get()>>8)));
+	/* double shift: (a<<(LEN-1)) | (b>>1) */
+	inline char_vec_t dsr(char_vec_t const &b) const {
+		return(char_vec_t(T::cdsr(v, b.get())));
 	}
-	/* double shift: (a<<1) | (b>>7) */
-	inline char_vec dsl(char_vec const &b) const {
-		return(char_vec((v<<8) | (b.get()>>56)));
+	/* double shift: (a<<1) | (b>>(LEN-1)) */
+	inline char_vec_t dsl(char_vec_t const &b) const {
+		return(char_vec_t(T::cdsl(v, b.get())));
 	}
 	/* binary assign */
-	inline char_vec operator&=(char_vec const &b) { return(operator=(operator&(b))); }
-	inline char_vec operator|=(char_vec const &b) { return(operator=(operator|(b))); }
-	inline char_vec operator<<=(int s) { return(operator=(operator<<(s))); }
-	inline char_vec operator>>=(int s) { return(operator=(operator>>(s))); }
+	inline char_vec_t operator&=(char_vec_t const &b) { return(operator=(operator&(b))); }
+	inline char_vec_t operator|=(char_vec_t const &b) { return(operator=(operator|(b))); }
 	/* array */
 	inline int8_t operator[](uint64_t i) const {
-		if(i < 8) {
-			return(operator>>(i).get() & 0xff);
-		} else {
-			return(0);
-		}
+		return(T::cextract(v, i));
 	}
 	inline int8_t lsb(void) const { return(operator[](0)); }
-	inline int8_t center(void) const { return(operator[](4)); }
-	inline int8_t msb(void) const { return(operator[](7)); }
-	inline int8_t ins(int8_t k, uint64_t i) {
-		if(i < 8) {
-			v = (v & ~(0xff<<(8*i))) | (k<<(8*i));
-		} else {
-			return(0);
-		}
-		return(k);
-	}
+	inline int8_t center(void) const { return(operator[](LEN / 2)); }
+	inline int8_t msb(void) const { return(operator[](LEN - 1)); }
 
 	/* load and store */
 	inline void load(void const *ptr) {
-		v = *((uint64_t *)ptr);
+		v = T::cload(ptr);
 	}
 	inline void loadu(void const *ptr) {
 		load(ptr);
 	}
 	inline void load_encode_a(void const *ptr, uint64_t len) {
-		load(ptr);
-		len = len > 8 ? 8 : len; len--;
-		v = (0x0303030303030303>>8*(7 - len)) & ((v>>1) ^ (v>>2));
-		v |= 0x0909090909090900<<8*len;
+		v = T::cpad(T::cencode_a(T::cload(ptr)), len);
 	}
 	inline void load_encode_b(void const *ptr, uint64_t len) {
 		load(ptr);
-		len = len > 8 ? 8 : len; len--;
-		v = (0x0c0c0c0c0c0c0c0c>>8*(7 - len)) & ((v<<1) ^ v);
-		v |= 0x0909090909090900<<8*len;
+		encode_b(len, 0);
+	}
+	/* load (at most) LEN bytes backward from ptr (exclusive), complemented if comp != 0 */
+	inline void loadr_encode_b(void const *ptr, uint64_t len, uint64_t comp) {
+		if(len >= LEN) {
+			load((uint8_t const *)ptr - LEN);
+		} else {
+			uint8_t b[LEN];
+			memset(b, 0, LEN - len); memcpy(b + LEN - len, (uint8_t const *)ptr - len, len);
+			load(b);
+		}
+		v = T::creverse(v);
+		encode_b(len, comp);
+	}
+	/* load (at most) LEN bases from the i-th 2-bit field of the packed array */
+	inline void loadp_encode_b(uint8_t const *ptr, uint64_t i, uint64_t len) {
+		uint64_t b[LEN / 8];
+		for(uint64_t k = 0; k < LEN / 8; k++) {
+			uint64_t const j = i + 8*k, l = len > 8*k ? len - 8*k : 0;
+			uint64_t n = ((j & 0x03) + (l > 8 ? 8 : l) + 3) / 4;
+			uint32_t t = 0; memcpy(&t, &ptr[j>>2], l == 0 ? 0 : n);
+			uint64_t x = (t>>(2*(j & 0x03))) & 0xffff;
+			x = (x | (x<<24)) & 0x000000ff000000ff;
+			x = (x | (x<<12)) & 0x000f000f000f000f;
+			x = (x | (x<<6)) & 0x0303030303030303;
+			b[k] = x<<2;
+		}
+		v = T::cpad(T::cload(b), len);
+	}
+	/* encode ascii in place, lanes beyond len are filled with encode_n() */
+	inline void encode_b(uint64_t len, uint64_t comp) {
+		v = T::cpad(T::cencode_b(v, comp), len);
 	}
 	inline void store(void *ptr) const {
-		*((uint64_t *)ptr) = v;
+		T::cstore(ptr, v);
 	}
 	inline void storeu(void *ptr) const {
 		store(ptr);
@@ -163,7 +591,10 @@ public:
 		print(stderr, msg);
 	}
 	void print(FILE *fp, char const *msg) const {
-		fprintf(fp, "%s%s[%016llx]\n", msg == NULL ? "" : msg, msg == NULL ? "" : " ", v);
+		uint8_t b[LEN]; store(b);
+		fprintf(fp, "%s%s[", msg == NULL ? "" : msg, msg == NULL ? "" : " ");
+		for(uint64_t i = 0; i < LEN; i++) { fprintf(fp, "%02x", b[LEN - 1 - i]); }
+		fprintf(fp, "]\n");
 	}
 	#else
 	void print(void) const {}
@@ -173,225 +604,168 @@ public:
 };
 
 /**
- * @class vec
+ * @class vec_t
  *
- * @brief SSE4.1 16bit 8cell
+ * @brief 16bit cells, LEN cells per register
  */
-class vec {
+template<typename T>
+class vec_t {
 
 private:
-	__m128i v;
+	typedef typename T::reg reg;
+	reg v;
 
 public:
 	/* consts */
 	static uint16_t const MAX = 65535;
 	static uint16_t const MIN = 0;
-	static uint64_t const SIZE = sizeof(__m128i);
-	static uint64_t const LEN = sizeof(__m128i) / sizeof(uint16_t);
+	static uint64_t const SIZE = sizeof(reg);
+	static uint64_t const LEN = sizeof(reg) / sizeof(uint16_t);
+	static uint64_t const MASK = ~0ULL>>(64 - 2*LEN);	/* comparison result of all the cells */
 
 	/* constructors */
-	vec(void) {
+	vec_t(void) {
 		set(0);
 	}
-	vec(uint16_t k) {
+	vec_t(uint16_t k) {
 		set(k);
 	}
-	vec(__m128i i) {
+	vec_t(reg i) {
 		v = i;
 	}
-	vec(__m128i const *p) {
-		v = _mm_load_si128(p);
+	vec_t(reg const *p) {
+		v = T::load(p);
 	}
-	vec(uint16_t const *p) {
-		v = _mm_load_si128((__m128i const *)p);
+	vec_t(uint16_t const *p) {
+		v = T::load(p);
 	}
 
 	/* setter */
 	inline void zero(void) {
-		v = _mm_setzero_si128();
+		v = T::zero();
 	}
 	inline void set(int16_t k) {
-		v = _mm_set1_epi16(k);
+		v = T::set1(k);
 	}
 
 	/* getter */
-	inline __m128i const &get(void) const { return(v); }
+	inline reg const &get(void) const { return(v); }
 
 	/* assign */
-	inline vec operator=(vec const &b) {
-		return(vec(v = b.get()));
+	inline vec_t operator=(vec_t const &b) {
+		return(vec_t(v = b.get()));
 	}
 
 	/* add */
-	inline vec operator+(vec const &b) const {
-		return(vec(_mm_add_epi16(v, b.get())));
+	inline vec_t operator+(vec_t const &b) const {
+		return(vec_t(T::add(v, b.get())));
 	}
 	/* sub */
-	inline vec operator-(vec const &b) const {
-		return(vec(_mm_subs_epu16(v, b.get())));
+	inline vec_t operator-(vec_t const &b) const {
+		return(vec_t(T::subs(v, b.get())));
 	}
 	/* and */
-	inline vec operator&(vec const &b) const {
-		return(vec(_mm_and_si128(v, b.get())));
+	inline vec_t operator&(vec_t const &b) const {
+		return(vec_t(T::and_(v, b.get())));
 	}
 	/* or */
-	inline vec operator|(vec const &b) const {
-		return(vec(_mm_or_si128(v, b.get())));
+	inline vec_t operator|(vec_t const &b) const {
+		return(vec_t(T::or_(v, b.get())));
 	}
 	/* compare */
-	inline uint16_t operator<(vec const &b) const {
-		__m128i _ofs = _mm_set1_epi16(32768);
-		__m128i _a = _mm_sub_epi16(v, _ofs);
-		__m128i _b = _mm_sub_epi16(b.get(), _ofs);
-		return(_mm_movemask_epi8(_mm_cmplt_epi16(_a, _b)));
-	}
-	inline uint16_t operator>(vec const &b) const {
-		__m128i _ofs = _mm_set1_epi16(32768);
-		__m128i _a = _mm_sub_epi16(v, _ofs);
-		__m128i _b = _mm_sub_epi16(b.get(), _ofs);
-		return(_mm_movemask_epi8(_mm_cmpgt_epi16(_a, _b)));
-	}
-	inline uint16_t operator<=(vec const &b) const { return(~operator>(b)); }
-	inline uint16_t operator>=(vec const &b) const { return(~operator<(b)); }
-	inline uint16_t operator==(vec const &b) const {
-		return(_mm_movemask_epi8(_mm_cmpeq_epi16(v, b.get())));
-	}
-	inline uint16_t operator!=(vec const &b) const {
-		return(~_mm_movemask_epi8(_mm_cmpeq_epi16(v, b.get())));
-	}
+	inline uint64_t operator<(vec_t const &b) const { return(T::gt(b.get(), v)); }
+	inline uint64_t operator>(vec_t const &b) const { return(T::gt(v, b.get())); }
+	inline uint64_t operator<=(vec_t const &b) const { return(MASK & ~operator>(b)); }
+	inline uint64_t operator>=(vec_t const &b) const { return(MASK & ~operator<(b)); }
+	inline uint64_t operator==(vec_t const &b) const { return(T::eq(v, b.get())); }
+	inline uint64_t operator!=(vec_t const &b) const { return(MASK & ~operator==(b)); }
 	/* shift left */
-	inline vec operator<<(int s) const {
-		switch(s) {
-		#define l(n) c(n+1) c(n+2) c(n+3) c(n+4) c(n+5) c(n+6) c(n+7)
-			case 0: return(vec(v));
-		#define c(n) case n: return(vec(_mm_slli_si128(v, 2*(n))));
-			l(0);
-		#undef c
-			default: return(vec(_mm_setzero_si128()));
-		#undef l
-		}
+	inline vec_t operator<<(int s) const {
+		return(vec_t(T::shl(v, s)));
 	}
-	inline vec operator>>(int s) const {
-		switch(s) {
-		#define l(n) c(n+1) c(n+2) c(n+3) c(n+4) c(n+5) c(n+6) c(n+7)
-			case 0: return(vec(v));
-		#define c(n) case n: return(vec(_mm_srli_si128(v, 2*(n))));
-			l(0);
-		#undef c
-			default: return(vec(_mm_setzero_si128()));
-		#undef l
-		}
+	inline vec_t operator>>(int s) const {
+		return(vec_t(T::shr(v, s)));
 	}
-	/* double shift: (a<<7) | (b>>1) */
-	inline vec dsr(vec const &b) const {
-		return(vec(_mm_alignr_epi8(v, b.get(), 2)));
+	/* double shift: (a<<(LEN-1)) | (b>>1) */
+	inline vec_t dsr(vec_t const &b) const {
+		return(vec_t(T::dsr(v, b.get())));
 	}
-	/* double shift: (a<<1) | (b>>7) */
-	inline vec dsl(vec const &b) const {
-		return(vec(_mm_alignr_epi8(v, b.get(), 14)));
+	/* double shift: (a<<1) | (b>>(LEN-1)) */
+	inline vec_t dsl(vec_t const &b) const {
+		return(vec_t(T::dsl(v, b.get())));
+	}
+	/* the msb cell broadcast to all the cells */
+	inline vec_t bcast_msb(void) const {
+		return(vec_t(T::bcast_msb(v)));
+	}
+	/* gap propagation toward the msb: [i] = max([j] - (i - j) * ge) over j <= i */
+	inline vec_t scan(uint16_t ge) const {
+		return(vec_t(T::scan(v, ge)));
 	}
 	/* binary assign */
-	inline vec operator+=(vec const &b) { return(operator=(operator+(b))); }
-	inline vec operator-=(vec const &b) { return(operator=(operator-(b))); }
-	inline vec operator&=(vec const &b) { return(operator=(operator&(b))); }
-	inline vec operator|=(vec const &b) { return(operator=(operator|(b))); }
-	inline vec operator<<=(int s) { return(operator=(operator<<(s))); }
-	inline vec operator>>=(int s) { return(operator=(operator>>(s))); }
+	inline vec_t operator+=(vec_t const &b) { return(operator=(operator+(b))); }
+	inline vec_t operator-=(vec_t const &b) { return(operator=(operator-(b))); }
+	inline vec_t operator&=(vec_t const &b) { return(operator=(operator&(b))); }
+	inline vec_t operator|=(vec_t const &b) { return(operator=(operator|(b))); }
+	inline vec_t operator<<=(int s) { return(operator=(operator<<(s))); }
+	inline vec_t operator>>=(int s) { return(operator=(operator>>(s))); }
 	/* array */
 	inline uint16_t operator[](uint64_t const i) const {
-		#ifdef DEBUG2
-			switch(i) {
-				case 0: return((uint16_t)_mm_extract_epi16(v, 0));
-				case 1: return((uint16_t)_mm_extract_epi16(v, 1));
-				case 2: return((uint16_t)_mm_extract_epi16(v, 2));
-				case 3: return((uint16_t)_mm_extract_epi16(v, 3));
-				case 4: return((uint16_t)_mm_extract_epi16(v, 4));
-				case 5: return((uint16_t)_mm_extract_epi16(v, 5));
-				case 6: return((uint16_t)_mm_extract_epi16(v, 6));
-				case 7: return((uint16_t)_mm_extract_epi16(v, 7));
-				default: return(0);
-			}
-		#else
-			if(i < 8) {
-				return((uint16_t)_mm_extract_epi16(v, i));
-			} else {
-				return(0);
-			}
-		#endif
+		return(T::extract(v, i));
 	}
 	inline uint16_t lsb(void) const { return(operator[](0)); }
-	inline uint16_t center(void) const { return(operator[](4)); }
-	inline uint16_t msb(void) const { return(operator[](7)); }
-	inline uint16_t ins(uint16_t k, uint64_t const i) {
-		#ifdef DEBUG2
-			switch(i) {
-				case 0: v = _mm_insert_epi16(v, k, 0); return(k);
-				case 1: v = _mm_insert_epi16(v, k, 1); return(k);
-				case 2: v = _mm_insert_epi16(v, k, 2); return(k);
-				case 3: v = _mm_insert_epi16(v, k, 3); return(k);
-				case 4: v = _mm_insert_epi16(v, k, 4); return(k);
-				case 5: v = _mm_insert_epi16(v, k, 5); return(k);
-				case 6: v = _mm_insert_epi16(v, k, 6); return(k);
-				case 7: v = _mm_insert_epi16(v, k, 7); return(k);
-				default: return(0);
-			}
-		#else
-			if(i < 8) {
-				v = _mm_insert_epi16(v, k, i);
-			} else {
-				return(0);
-			}
-		#endif
-		return(k);
-	}
+	inline uint16_t center(void) const { return(operator[](LEN / 2)); }
+	inline uint16_t msb(void) const { return(operator[](LEN - 1)); }
 
 	/* compare and select */
-	inline vec static comp(vec const &a, vec const &b) {
-		return(vec(_mm_cmpeq_epi16(a.get(), b.get())));
+	inline vec_t static comp(vec_t const &a, vec_t const &b) {
+		return(vec_t(T::cmpeq(a.get(), b.get())));
+	}
+	inline vec_t select(uint16_t m, uint16_t x) const {
+		return(vec_t(T::blend(T::set1(x), T::set1(m), v)));
 	}
-	inline vec select(uint16_t m, uint16_t x) const {
-		__m128i mv = _mm_set1_epi16(m);
-		__m128i xv = _mm_set1_epi16(x);
-		return(vec(_mm_blendv_epi8(xv, mv, v)));
+	inline vec_t select(vec_t const &m, vec_t const &x) const {
+		return(vec_t(T::blend(x.get(), m.get(), v)));
 	}
-	inline vec select(vec const &m, vec const &x) const {
-		return(vec(_mm_blendv_epi8(x.get(), m.get(), v)));
+	/* table lookup; the table must be loaded with load_table */
+	inline vec_t shuffle(char_vec_t<T> const &a) const {
+		return(vec_t(T::shuffle(v, a.get())));
 	}
-	inline vec shuffle(char_vec const &a) const {
-		__m128i index = _mm_cvtsi64_si128(a.get());
-		return(vec(_mm_cvtepi8_epi16(_mm_shuffle_epi8(v, index))));
+	/* two-dimensional lookup on the chars of a and b (see aa_matrix_t in util.h) */
+	inline vec_t static gather(int8_t const *t, char_vec_t<T> const &a, char_vec_t<T> const &b) {
+		return(vec_t(T::gather(t, a.get(), b.get())));
 	}
 	/* make mask */
-	inline int64_t mask(void) const {
-		return(_mm_movemask_epi8(v));
+	inline uint64_t mask(void) const {
+		return(T::mask(v));
 	}
 	/* max */
-	inline vec static max(vec const &a, vec const &b) {
-		return(vec(_mm_max_epu16(a.get(), b.get())));
+	inline vec_t static max(vec_t const &a, vec_t const &b) {
+		return(vec_t(T::max(a.get(), b.get())));
 	}
 	/* horizontal max */
 	inline uint16_t hmax(void) const {
-		__m128i t = _mm_max_epu16(v, _mm_srli_si128(v, 2));
-		t = _mm_max_epu16(t, _mm_srli_si128(t, 4));
-		t = _mm_max_epu16(t, _mm_srli_si128(t, 8));
-		return((uint16_t)_mm_extract_epi16(t, 0));
+		return(T::hmax(v));
 	}
 	/* load and store */
 	inline void load(void const *ptr) {
-		v = _mm_load_si128((__m128i *)ptr);
+		v = T::load(ptr);
 	}
 	inline void loadu(void const *ptr) {
-		v = _mm_loadu_si128((__m128i *)ptr);
+		v = T::loadu(ptr);
+	}
+	/* 16-byte table (score matrix) for shuffle */
+	inline void load_table(void const *ptr) {
+		v = T::table(ptr);
 	}
-	inline void load_expand(void const *ptr) {
-		uint64_t a = *((uint64_t *)ptr);
-		v = _mm_cvtepu8_epi16(_mm_cvtsi64_si128(a));
+	inline vec_t static table(void const *ptr) {
+		return(vec_t(T::table(ptr)));
 	}
 	inline void store(void *ptr) const {
-		_mm_store_si128((__m128i *)ptr, v);
+		T::store(ptr, v);
 	}
 	inline void storeu(void *ptr) const {
-		_mm_storeu_si128((__m128i *)ptr, v);
+		T::storeu(ptr, v);
 	}
 	/* print */
 	#ifdef DEBUG
@@ -402,12 +776,10 @@ public:
 		print(stderr, msg);
 	}
 	void print(FILE *fp, char const *msg) const {
-		uint16_t b[8] __attribute__(( aligned (16) ));
-		store(b);
-		fprintf(fp,
-			"%s%s[%d, %d, %d, %d, %d, %d, %d, %d]\n",
-			msg == NULL ? "" : msg, msg == NULL ? "" : " ",
-			b[7] - 32768, b[6] - 32768, b[5] - 32768, b[4] - 32768, b[3] - 32768, b[2] - 32768, b[1] - 32768, b[0] - 32768);
+		uint16_t b[LEN]; storeu(b);
+		fprintf(fp, "%s%s[", msg == NULL ? "" : msg, msg == NULL ? "" : " ");
+		for(uint64_t i = 0; i < LEN; i++) { fprintf(fp, "%s%d", i == 0 ? "" : ", ", b[LEN - 1 - i] - 32768); }
+		fprintf(fp, "]\n");
 	}
 	#else
 	void print(void) const {}
@@ -415,9 +787,22 @@ public:
 	void print(FILE *fp, char const *msg) const {}
 	#endif
 };
+
 /**
- * end of SSE4.1 16bit 8cell
+ * the widest instruction set enabled by the compiler flags
  */
+#if defined(__AVX512BW__)
+typedef avx512_t isa_t;
+#elif defined(__AVX2__)
+typedef avx2_t isa_t;
+#else
+typedef sse41_t isa_t;
+#endif
+
+typedef char_vec_t<isa_t> char_vec;
+typedef vec_t<isa_t> vec;
+
+}	/* namespace */
 
 #endif
 /**
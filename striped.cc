@@ -5,6 +5,7 @@
  * @brief striped parallelization of the standard banded matrix
  */
 #include <string.h>
+#include "isa.h"
 #include "sse.h"
 #include "util.h"
 #include "log.h"
@@ -14,10 +15,12 @@
 #define roundup(a, bound)		( (((a) + (bound) - 1) / (bound)) * (bound) )
 
 /**
- * @fn striped_affine
+ * @fn striped_affine_intl
  */
+template<typename T>
+static inline
 int
-striped_affine(
+striped_affine_intl(
 	void *work,
 	char const *a,
 	uint64_t alen,
@@ -25,6 +28,8 @@ striped_affine(
 	uint64_t blen,
 	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
 {
+	typedef vec_t<T> vec;
+
 	if(alen == 0 || blen == 0) { return(0); }
 	debug("%s, %s", a, b);
 
@@ -37,9 +42,9 @@ striped_affine(
 
 	/* construct score profile vector */
 	uint64_t tlen = (blen + 2 * bw - 1) / _blen();
-	if(tlen < vec::LEN) { tlen = vec::LEN; }
+	tlen = roundup(tlen, vec::LEN);			/* keeps the vectors below aligned */
 
-	uint16_t *scv = (uint16_t *)((uint8_t *)work + sizeof(maxpos_t));
+	uint16_t *scv = (uint16_t *)((uint8_t *)work + arena_roundup(sizeof(maxpos_t)));
 	uint16_t *base = scv + 4 * _blen() * tlen;
 
 	#define _scv(_s, _t, _k)		( scv[(((_s) * 4 + (_k)) * tlen) + (_t)] )
@@ -72,11 +77,13 @@ striped_affine(
 	_e(curr, bw % _blen(), bw / _blen()) = OFS + gi;
 	_f(curr, bw % _blen(), bw / _blen()) = OFS + gi;
 	uint64_t smax = OFS, amax = 0;				/* max score and its position */
+	uint64_t cmax = OFS;						/* max of the center cells */
 
 	vec const giv(-gi), gev(-ge), gebv(-ge * _blen());
 	vec max(OFS);
 	#ifdef DEBUG
 		uint64_t fcnt = 0;						/* lazy-f chain length */
+		uint64_t acnt = alen;					/* #rows calculated */
 	#endif
 	for(uint64_t apos = 0; apos < alen; apos++) {
 		debug("apos(%llu)", apos);
@@ -149,6 +156,17 @@ striped_affine(
 		uint16_t m = max.hmax();
 		debug("m(%d), pm(%d)", m - OFS, smax - OFS);
 		if(m > smax) { smax = m; amax = apos + 1; }
+
+		/* X-drop test on the center (diagonal) cell, the same as the adaptive band */
+		uint64_t c = _s(curr, bw % _blen(), bw / _blen());
+		cmax = MAX2(cmax, c);
+		if(c + xt < cmax) {
+			debug("xdrop");
+			#ifdef DEBUG
+				acnt = apos + 1;
+			#endif
+			break;
+		}
 	}
 
 	/* save the maxpos */
@@ -156,7 +174,7 @@ striped_affine(
 	r->alen = alen;
 	r->blen = blen;
 	#ifdef DEBUG
-		r->ccnt = alen * 2 * bw;
+		r->ccnt = acnt * 2 * bw;
 		r->fcnt = fcnt;
 	#endif
 
@@ -177,6 +195,21 @@ striped_affine(
 	return(m - OFS);
 }
 
+/**
+ * @fn striped_affine
+ */
+int
+_isa(striped_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(striped_affine_intl<isa_t>(work, a, alen, b, blen, score_matrix, gi, ge, xt, bw));
+}
+
 #ifdef MAIN
 #include <assert.h>
 #include <stdlib.h>
@@ -202,7 +235,7 @@ int main_ext(int argc, char *argv[])
 		printf("./a.out AAA AAA 2 -3 -5 -1 30\n");
 	}
 
-	int score = striped_affine(
+	int score = _isa(striped_affine)(
 		work,
 		a, alen, b, blen,
 		score_matrix,
@@ -224,7 +257,7 @@ int main(int argc, char *argv[])
 	void *work = aligned_malloc(128 * 1024 * 1024, 16);
 
 	#define a(s, p, q) { \
-		assert(striped_affine(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10, 32) == (s)); \
+		assert(_isa(striped_affine)(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10, 32) == (s)); \
 	}
 	a( 0, "", "");
 	a( 0, "A", "");
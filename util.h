@@ -23,10 +23,43 @@ typedef struct maxpos_s {
 	uint64_t alen, blen;
 	uint64_t ccnt;				/** #cells calculated */
 	uint64_t fcnt;				/** lazy-f count for debugging */
+	uint64_t mcnt, lcnt, ocnt;	/** #matches, #aligned columns, and #gap opens on the path to the max (adaptive_ident) */
+	uint64_t stage;				/** stage the pair ended at (chain_stage_e, adaptive_chain) */
 	char *path;
 	uint64_t path_length;
 } maxpos_t;
 
+/* per-threshold result of a multi-X pass (adaptive_mx, blast_mx), or per-scheme of adaptive_ms: the score, and where it ended */
+typedef struct xdrop_result_s {
+	int64_t score;
+	uint64_t apos, bpos;
+} xdrop_result_t;
+#define XDROP_LIST_MAX			( 16 )
+
+/* a scoring scheme of the multi-scheme kernels (adaptive_ms, sw_multi_affine): match, mismatch, gaps, and X, signed as the kernel args */
+typedef struct scheme_s {
+	int8_t m, x, gi, ge;
+	int16_t xt;
+} scheme_t;
+#define SCHEME_MAX				( 64 )
+
+/*
+ * gap models of the SIMD kernels: affine (gi + k * ge for a gap of k), linear (k * ge),
+ * or dual affine, the better of (gi, ge) and a second pair (gi2, ge2) opening higher and
+ * extending lower, so that long gaps cost less (minimap2)
+ */
+enum gap_model_e { GAP_AFFINE = 0, GAP_LINEAR = 1, GAP_DUAL = 2 };
+
+/*
+ * alignment modes: extension anchored at (0, 0), the best cell anywhere; local, the cells floored
+ * at zero; end-free, anchored at (0, 0), the best cell on the last row or column; global, from
+ * (0, 0) to (alen, blen)
+ */
+enum align_mode_e { ALIGN_EXTEND = 0, ALIGN_LOCAL = 1, ALIGN_ENDFREE = 2, ALIGN_GLOBAL = 3 };
+
+/* stages of the fallback chain (adaptive_chain_affine), left in maxpos_t.stage */
+enum chain_stage_e { CHAIN_NARROW = 0, CHAIN_WIDE = 1, CHAIN_SIMDBLAST = 2, CHAIN_EXACT = 3, CHAIN_STAGES = 4 };
+
 /**
  * aligned malloc
  */
@@ -109,6 +142,87 @@ int8_t extract_min_score(int8_t *matrix)
 	return(_mm_extract_epi8(a, 0));
 }
 
+/**
+ * protein (and any other alphabet up to 31 letters) scoring: a residue is encoded
+ * to AA_BASE plus its index in the matrix, and the score table is AA_DIM x AA_DIM,
+ * indexed by (a & (AA_DIM - 1)) * AA_DIM + (b & (AA_DIM - 1)). The rows and columns
+ * out of the matrix (encode_n() tails and the band pads) hold its min.
+ */
+#define AA_DIM			( 64 )
+#define AA_BASE			( 0x20 )
+
+typedef struct aa_matrix_s {
+	int8_t score[AA_DIM * AA_DIM + 4];	/* the 4 bytes after the last entry for dword gathers */
+	int8_t map[256];					/* ascii -> code */
+	int8_t max, min;
+} aa_matrix_t;
+
+/**
+ * @fn build_aa_matrix
+ *
+ * @brief from a parasail-style matrix: size x size scores in the order of the
+ * indices that map gives to ascii chars
+ */
+static inline
+int build_aa_matrix(aa_matrix_t *m, int const *matrix, int const *map, int size)
+{
+	if(size > AA_DIM - AA_BASE - 1) { return(-1); }
+
+	int mx = matrix[0], mn = matrix[0];
+	for(int i = 0; i < size * size; i++) {
+		mx = matrix[i] > mx ? matrix[i] : mx;
+		mn = matrix[i] < mn ? matrix[i] : mn;
+	}
+	m->max = mx; m->min = mn;
+
+	memset(m->score, mn, sizeof(m->score));
+	for(int i = 0; i < size; i++) {
+		for(int j = 0; j < size; j++) {
+			m->score[(AA_BASE + i) * AA_DIM + AA_BASE + j] = matrix[i * size + j];
+		}
+	}
+	for(int c = 0; c < 256; c++) { m->map[c] = AA_BASE + map[c]; }
+	return(0);
+}
+
+/**
+ * quality-aware scoring: the quality of each base of a selects one of nbin (up to
+ * QV_BINS_MAX) 16-entry tables, bin k taking the qualities from thresh[k] up to
+ * thresh[k + 1]. The kernels carry the bin in bits 4 to 6 of the code of a, which
+ * the shuffle ignores. The qualities of a are passed apart, with each pair.
+ */
+#define QV_BINS_MAX		( 8 )
+
+typedef struct qv_matrix_s {
+	int8_t score[QV_BINS_MAX][16];		/* first; a table per bin */
+	uint8_t bin[256];					/* quality -> bin */
+	int8_t max, min;
+	uint8_t nbin;
+} qv_matrix_t;
+
+/**
+ * @fn build_qv_matrix
+ *
+ * @brief bin k scores m[k] on match and x[k] on mismatch; thresh[0] is taken as zero
+ */
+static inline
+int build_qv_matrix(qv_matrix_t *q, int8_t const *m, int8_t const *x, uint8_t const *thresh, int nbin)
+{
+	if(nbin < 1 || nbin > QV_BINS_MAX) { return(-1); }
+
+	memset(q, 0, sizeof(qv_matrix_t));
+	q->nbin = nbin; q->max = m[0]; q->min = x[0];
+	for(int k = 0; k < nbin; k++) {
+		build_score_matrix(q->score[k], m[k], x[k]);
+		q->max = m[k] > q->max ? m[k] : q->max;
+		q->min = x[k] < q->min ? x[k] : q->min;
+	}
+	for(int c = 0, k = 0; c < 256; c++) {
+		while(k + 1 < nbin && c >= thresh[k + 1]) { k++; }
+		q->bin[c] = k;
+	}
+	return(0);
+}
 
 /**
  * @macro popcnt
@@ -190,12 +304,78 @@ int8_t extract_min_score(int8_t *matrix)
 #define MIN3(x,y,z) 	( MIN2(x, MIN2(y, z)) )
 #define MIN4(w,x,y,z) 	( MIN2(MIN2(w, x), MIN2(y, z)) )
 
+/**
+ * work arena: the banded kernels keep their band state (char buffers, the
+ * adaptive lanes) at the head of the caller-provided work, after maxpos_t,
+ * and the dp history after it, each part starting on a cache line. The work
+ * must be ARENA_ALIGN-aligned and bw up to BW_MAX.
+ */
+#define ARENA_ALIGN				( 64 )
+#define BW_MAX					( 1024 )
+#define arena_roundup(_x)		( ((size_t)(_x) + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1) )
+
+/**
+ * @fn work_size
+ *
+ * @brief upper bound of the arena the banded kernels (scalar, vertical,
+ * diagonal, striped, and adaptive up to 4x widened) use on a pair
+ */
+static inline
+size_t work_size(
+	uint32_t bw,
+	uint64_t alen,
+	uint64_t blen)
+{
+	/* the adaptive lanes take 12 bytes each plus a pad vector of 32 lanes, and up to seven planes each
+	   rounded to a cache line (SoA layout); the char buffers 2 * bw + 32 */
+	size_t const head = arena_roundup(sizeof(maxpos_t)) + arena_roundup(12 * (4 * (size_t)bw + 32)) + 7 * ARENA_ALIGN;
+	/* adaptive: a lane per cell of an anti-diagonal */
+	size_t const adaptive = 2 * 4 * (size_t)bw * (alen + blen);
+	/* scalar, vertical, striped: s, e, f of 2 * bw cells per row, striped with its profile of 4 rows */
+	size_t const row = 12 * (size_t)bw * (alen + 1) + 8 * (blen + 4 * (size_t)bw + 64);
+	/* diagonal: s, e, f of bw cells per anti-diagonal */
+	size_t const diag = 6 * (size_t)bw * (alen + blen + 2);
+	return(head + MAX3(adaptive, row, diag));
+}
+
+/**
+ * @struct stream_s
+ *
+ * @brief a suspended streaming extension (adaptive_stream): the scalars of the
+ * band and its bw lanes in lane order, b and a in a byte each, then pv, cv, ce,
+ * cf, and max in 16 bits each; STREAM_SIZE(bw) bytes in all. It holds no
+ * pointers, so the bytes are copied as they are to move the extension to
+ * another thread, or to any isa whose vector divides bw.
+ */
+typedef struct stream_s {
+	int64_t score;				/* the best so far, final once STREAM_DONE */
+	uint64_t apos, bpos, p, rbase;
+	uint32_t bw, dir, rcnt, flag;
+	uint8_t lane[];
+} stream_t;
+enum stream_flag_e { STREAM_STARTED = 0x01, STREAM_DONE = 0x02 };
+#define STREAM_SIZE(_bw)		( sizeof(stream_t) + 12 * (size_t)(_bw) )
+
+/**
+ * @fn stream_init
+ *
+ * @brief an extension not started yet, at band width bw; st takes STREAM_SIZE(bw) bytes
+ */
+static inline
+void stream_init(stream_t *st, uint32_t bw)
+{
+	memset(st, 0, STREAM_SIZE(bw));
+	st->bw = bw;
+	return;
+}
+
 
 /* split_foreach */
 #define mm_split_foreach(_ptr, _delims, _body) { \
 	char const *_q = (_ptr); \
 	int64_t i = 0; \
-	__m128i _dv = _mm_loadu_si128((__m128i const *)_delims); \
+	char _db[16] = { 0 }; strncpy(_db, (_delims), 15);			/* the delimiters may be shorter than the vector */ \
+	__m128i _dv = _mm_loadu_si128((__m128i const *)_db); \
 	uint16_t _m, _mask = 0x02<<tzcnt(		/* reserve space for '\0' */ \
 		_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8('\0'), _dv)) \
 	); \
@@ -5,6 +5,7 @@
  * @brief vertical parallelization of the standard banded matrix
  */
 #include <string.h>
+#include "isa.h"
 #include "sse.h"
 #include "util.h"
 #include "log.h"
@@ -14,10 +15,12 @@
 #define roundup(a, bound)		( (((a) + (bound) - 1) / (bound)) * (bound) )
 
 /**
- * @fn vertical_affine
+ * @fn vertical_affine_intl
  */
+template<typename T>
+static inline
 int
-vertical_affine(
+vertical_affine_intl(
 	void *work,
 	char const *a,
 	uint64_t alen,
@@ -25,6 +28,9 @@ vertical_affine(
 	uint64_t blen,
 	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
 {
+	typedef vec_t<T> vec;
+	typedef char_vec_t<T> char_vec;
+
 	if(alen == 0 || blen == 0) { return(0); }
 	debug("%s, %s", a, b);
 
@@ -33,10 +39,12 @@ vertical_affine(
 	#define _e(_p, _i)		( (_p)[2 * bw + (_i)] )
 	#define _f(_p, _i)		( (_p)[4 * bw + (_i)] )
 	#define _vlen()			( 6 * bw )
-	uint8_t c[2 * bw + vec::LEN];
+
+	/* char buffer after maxpos_t, the vectors from the next cache line (see util.h) */
+	uint8_t *c = (uint8_t *)work + sizeof(maxpos_t);
 
 	/* init the leftmost vector (verticalically placed) */
-	uint16_t *base = (uint16_t *)((uint8_t *)work + sizeof(maxpos_t)), *curr = base, *prev = base;
+	uint16_t *base = (uint16_t *)((uint8_t *)work + arena_roundup(sizeof(maxpos_t) + 2 * bw + vec::LEN)), *curr = base, *prev = base;
 	#define _gap(_i)		( ((_i) > 0 ? gi : 0) + (_i) * ge )
 	for(uint64_t i = 0; i < 2 * bw; i++) {
 		if(i < bw) {
@@ -51,8 +59,9 @@ vertical_affine(
 	_e(curr, bw) = OFS + gi;					/* fix gap cells at (0, 0) */
 	_f(curr, bw) = OFS + gi;
 	uint64_t smax = OFS, amax = 0;				/* max score and its position */
+	uint64_t cmax = OFS, acnt = alen;			/* max of the center cells, #rows calculated */
 
-	vec const z, giv(-gi), gev(-ge), gev2(-2*ge), gev4(-4*ge), smv((uint16_t const *)score_matrix);
+	vec const z, giv(-gi), gev(-ge), smv(vec::table(score_matrix));
 	vec max(OFS);
 	for(uint64_t apos = 0; apos < alen; apos++) {
 		debug("apos(%llu)", apos);
@@ -88,10 +97,10 @@ vertical_affine(
 			pv = vec::max(pv, pe); pv.print("pv (tentative)");
 
 			/* calc f: verticalical gap propagation */
-			pf = vec::max(pv - giv, (pf>>7) - gev);
-			pf = vec::max(pf, (pf<<1) - gev);
-			pf = vec::max(pf, (pf<<2) - gev2);
-			pf = vec::max(pf, (pf<<4) - gev4);
+			pf = vec::max(pv - giv, (pf>>(vec::LEN - 1)) - gev);
+			for(uint64_t s = 1; s < vec::LEN; s <<= 1) {
+				pf = vec::max(pf, (pf<<s) - vec(-(int16_t)s*ge));
+			}
 
 			/* fixup s */
 			pv = vec::max(pv, pf); pv.print("pv");
@@ -106,6 +115,11 @@ vertical_affine(
 		uint16_t m = max.hmax();
 		debug("m(%u), pm(%u)", m, smax);
 		if(m > smax) { smax = m; amax = apos + 1; }
+
+		/* X-drop test on the center (diagonal) cell, the same as the adaptive band */
+		uint64_t c = _s(curr, bw);
+		cmax = MAX2(cmax, c);
+		if(c + xt < cmax) { debug("xdrop"); acnt = apos + 1; break; }
 	}
 
 	/* save the maxpos */
@@ -113,7 +127,7 @@ vertical_affine(
 	r->alen = alen;
 	r->blen = blen;
 	#ifdef debug
-		r->ccnt = alen * 2 * bw;
+		r->ccnt = acnt * 2 * bw;
 		r->fcnt = 0;
 	#endif
 
@@ -134,6 +148,21 @@ vertical_affine(
 	return(m - OFS);
 }
 
+/**
+ * @fn vertical_affine
+ */
+int
+_isa(vertical_affine)(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t *score_matrix, int8_t gi, int8_t ge, int16_t xt, uint32_t bw)
+{
+	return(vertical_affine_intl<isa_t>(work, a, alen, b, blen, score_matrix, gi, ge, xt, bw));
+}
+
 #ifdef MAIN
 #include <assert.h>
 #include <stdlib.h>
@@ -159,7 +188,7 @@ int main_ext(int argc, char *argv[])
 		printf("./a.out AAA AAA 2 -3 -5 -1 30\n");
 	}
 
-	int score = vertical_affine(
+	int score = _isa(vertical_affine)(
 		work,
 		a, alen, b, blen,
 		score_matrix,
@@ -181,7 +210,7 @@ int main(int argc, char *argv[])
 	void *work = aligned_malloc(128 * 1024 * 1024, 16);
 
 	#define a(s, p, q) { \
-		assert(vertical_affine(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10, 32) == (s)); \
+		assert(_isa(vertical_affine)(work, p, strlen(p), q, strlen(q), score_matrix, -1, -1, 10, 32) == (s)); \
 	}
 	a( 0, "", "");
 	a( 0, "A", "");
@@ -0,0 +1,186 @@
+
+/**
+ * @file wide.cc
+ *
+ * @brief register-resident wide-band adaptive banded (anti-diagonal) kernel
+ *
+ * @detail
+ * The same recurrence as adaptive.cc, but the whole band is kept in a set of
+ * concatenated registers with the multi-register macros in x86_64/ instead of
+ * being streamed through the work array. The band width is fixed at compile
+ * time by BAND_WIDTH (64, 128, or 256; see makefile), and the kernel is
+ * exported as wide<BAND_WIDTH>_affine_<isa>. Cells are signed 16-bit without
+ * offset.
+ */
+#include <string.h>
+#include <limits.h>
+#include "isa.h"
+#include "seq.h"
+#include "util.h"
+
+#ifndef BAND_WIDTH
+#  define BAND_WIDTH			64
+#endif
+
+/* x86_64/ headers are selected on these two (do not include ./sse.h here) */
+#define SIMD_BIT_WIDTH			16
+#define SIMD_BAND_WIDTH			BAND_WIDTH
+#if defined(__AVX2__)
+#  include "x86_64/avx.h"
+#else
+#  include "x86_64/sse.h"
+#endif
+
+#define CELL_MIN 				( SHRT_MIN )
+#define SAT(a)					( (a) < CELL_MIN ? CELL_MIN : (a) )
+
+/* char vector shift operations (see ddiag.h) */
+#define PUSHQ(x, y)				{ VEC_CHAR_SHIFT_L(y); VEC_CHAR_INSERT_LSB(y, x); }
+#define PUSHT(x, y)				{ VEC_CHAR_SHIFT_R(y); VEC_CHAR_INSERT_MSB(y, x); }
+
+/* chars out of the sequences; never match each other */
+#define A_TAIL					( 0x10 )
+#define B_TAIL					( 0x20 )
+#define A_PAD					( 0x80 )
+#define B_PAD					( 0xff )
+
+#define _wide_intl(_bw)			wide##_bw##_affine
+#define _wide(_bw)				_wide_intl(_bw)
+
+/**
+ * @fn wide_affine_intl
+ *
+ * @brief a and b are sequence views (see seq.h)
+ */
+template<typename A, typename B>
+static inline
+int
+wide_affine_intl(
+	void *work,
+	A const &a,
+	B const &b,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt)
+{
+	uint64_t const alen = a.len, blen = b.len;
+	if(alen == 0 || blen == 0) { return(0); }
+	debug("%llu, %llu", alen, blen);
+
+	int64_t const bw = BAND_WIDTH;
+
+	/* extract max and match / mismatch scores */
+	int8_t sc_max = extract_max_score(score_matrix);
+	int8_t m = score_matrix[0], x = score_matrix[1];
+	/* fix gap open penalty */
+	gi += ge;
+
+	DECLARE_VEC_CELL_REG(mv);
+	DECLARE_VEC_CELL_REG(xv);
+	DECLARE_VEC_CELL_REG(giv);
+	DECLARE_VEC_CELL_REG(gev);
+	DECLARE_VEC_CELL_REG(pv);
+	DECLARE_VEC_CELL_REG(cv);
+	DECLARE_VEC_CELL_REG(ce);
+	DECLARE_VEC_CELL_REG(cf);
+	DECLARE_VEC_CELL_REG(maxv);
+	DECLARE_VEC_CELL_REG(t);
+	DECLARE_VEC_CELL_REG(sc);
+	DECLARE_VEC_CHAR_REG(va);
+	DECLARE_VEC_CHAR_REG(vb);
+
+	VEC_SET(mv, m); VEC_SET(xv, x);
+	VEC_SET(giv, gi); VEC_SET(gev, ge);
+
+	/* init char vec */
+	VEC_CHAR_SETZERO(va); VEC_CHAR_SETZERO(vb);
+	for(int64_t i = 0; i < bw; i++) {
+		int64_t q = i - bw / 2;
+		PUSHT(q < 0 ? ((uint64_t)(-q - 1) < alen ? a.encode_a(-q - 1) : A_TAIL) : A_PAD, va);
+		PUSHT(q < 0 ? B_PAD : ((uint64_t)q < blen ? b.encode_a(q) : B_TAIL), vb);
+	}
+
+	/* init vec */
+	VEC_SETZERO(pv); VEC_SETZERO(cv); VEC_SETZERO(ce); VEC_SETZERO(cf);
+	for(int64_t i = 0; i < bw; i++) {
+		int64_t q = i - bw / 2;
+		VEC_SHIFT_R(pv); VEC_INSERT_MSB(pv, SAT(     (q < 0 ? -q     : q) * (2*gi - sc_max)));
+		VEC_SHIFT_R(cv); VEC_INSERT_MSB(cv, SAT(gi + (q < 0 ? -q - 1 : q) * (2*gi - sc_max)));
+		VEC_SHIFT_R(ce); VEC_INSERT_MSB(ce, SAT(gi + (q < 0 ? -q - 1 : q + 1) * (2*gi - sc_max)));
+		VEC_SHIFT_R(cf); VEC_INSERT_MSB(cf, SAT(gi + (q < 0 ? -q     : q) * (2*gi - sc_max)));
+	}
+	VEC_ASSIGN(maxv, pv);
+
+	/* direction determiner */
+	uint64_t const RR = 0, RD = 1, DR = 2, DD = 3;
+	uint64_t const dir_trans[2][4] = {{RR, DR, RR, DR}, {RD, DD, RD, DD}};
+	uint64_t dir = VEC_MSB(pv) <= VEC_LSB(pv) ? RR : RD;
+
+	uint64_t apos = bw / 2;
+	uint64_t bpos = bw / 2;
+	for(uint64_t p = 0; p < (uint64_t)(alen+blen-1); p++) {
+		dir = dir_trans[VEC_MSB(cv) > VEC_LSB(cv)][dir];
+
+		if(dir & 0x01) {
+			/* down: shift the band toward the lower lanes, fetch b at the top */
+			PUSHT(bpos < blen ? b.encode_a(bpos) : B_TAIL, vb);
+			bpos++;
+			VEC_COMPARE(t, va, vb); VEC_SELECT(sc, xv, mv, t);
+
+			if(dir == DD) { VEC_SHIFT_R(pv); VEC_INSERT_MSB(pv, CELL_MIN); }
+			VEC_ADD(pv, pv, sc);
+
+			/* e from the (shifted) left cell, f from the upper cell */
+			VEC_ASSIGN(t, cv); VEC_SHIFT_R(t); VEC_INSERT_MSB(t, CELL_MIN);
+			VEC_SHIFT_R(ce); VEC_INSERT_MSB(ce, CELL_MIN);
+			VEC_ADD(t, t, giv); VEC_ADD(ce, ce, gev); VEC_MAX(ce, ce, t);
+			VEC_ADD(t, cv, giv); VEC_ADD(cf, cf, gev); VEC_MAX(cf, cf, t);
+		} else {
+			/* right: shift the band toward the upper lanes, fetch a at the bottom */
+			PUSHQ(apos < alen ? a.encode_a(apos) : A_TAIL, va);
+			apos++;
+			VEC_COMPARE(t, va, vb); VEC_SELECT(sc, xv, mv, t);
+
+			if(dir == RR) { VEC_SHIFT_L(pv); VEC_INSERT_LSB(pv, CELL_MIN); }
+			VEC_ADD(pv, pv, sc);
+
+			/* f from the (shifted) upper cell, e from the left cell */
+			VEC_ASSIGN(t, cv); VEC_SHIFT_L(t); VEC_INSERT_LSB(t, CELL_MIN);
+			VEC_SHIFT_L(cf); VEC_INSERT_LSB(cf, CELL_MIN);
+			VEC_ADD(t, t, giv); VEC_ADD(cf, cf, gev); VEC_MAX(cf, cf, t);
+			VEC_ADD(t, cv, giv); VEC_ADD(ce, ce, gev); VEC_MAX(ce, ce, t);
+		}
+
+		/* update s */
+		VEC_MAX(t, ce, cf); VEC_MAX(t, t, pv);
+		VEC_ASSIGN(pv, cv); VEC_ASSIGN(cv, t);
+		VEC_MAX(maxv, maxv, cv);
+
+		if(VEC_CENTER(cv) < VEC_CENTER(maxv) - xt) {
+			debug("xdrop");
+			break;
+		}
+	}
+
+	int32_t max;
+	VEC_HMAX(max, maxv);
+	return(max);
+}
+
+/**
+ * @fn wide<BAND_WIDTH>_affine
+ */
+int
+_isa(_wide(BAND_WIDTH))(
+	void *work,
+	char const *a,
+	uint64_t alen,
+	char const *b,
+	uint64_t blen,
+	int8_t score_matrix[16], int8_t gi, int8_t ge, int16_t xt,
+	uint32_t bw)		/* fixed at BAND_WIDTH */
+{
+	return(wide_affine_intl(work, fw_view(a, alen), fw_view(b, blen), score_matrix, gi, ge, xt));
+}
+
+/**
+ * end of wide.cc
+ */
@@ -22,18 +22,25 @@
  * (e.g. 2 regs parallel) indicates the composition of a band, the middle of the
  * cell is the name of the header, and the bottom is an algorithmic capability of
  * the header.
- * +------------------------------------------------+
- * |            |            band width             |
- * |            |        16       |        32       |
- * +------------+-----------------+-----------------+
- * |            |  unsupported    | single register |
- * |          8 |    use sse4     |   avx_b8_r1.h   |
- * | bit        |    instead      |   diag / diff   |
- * | width      +-----------------+-----------------+
- * |            | single register | 2 regs parallel |
- * |         16 |  avx_b16_r1.h   |  avx_b16_r2.h   |
- * |            |   diag / diff   |   diag / diff   |
- * +------------+-----------------+-----------------+
+ * +--------------------------------------------------------------------------------------------------------+
+ * |            |                                      band width                                           |
+ * |            |        16       |        32       |        64       |       128        |       256        |
+ * +------------+-----------------+-----------------+-----------------+------------------+------------------+
+ * |            |  unsupported    | single register |                 |                  |                  |
+ * |          8 |    use sse4     |   avx_b8_r1.h   |   unsupported   |   unsupported    |   unsupported    |
+ * |            |    instead      |   diag / diff   |                 |                  |                  |
+ * | bit        +-----------------+-----------------+-----------------+------------------+------------------+
+ * | width      | single register | 2 regs parallel | 4 regs parallel | 8 regs parallel  | 16 regs parallel |
+ * |         16 |  avx_b16_r1.h   |  avx_b16_r2.h   |  avx_b16_r4.h   |   avx_b16_r8.h   |  avx_b16_r16.h   |
+ * |            |   diag / diff   |   diag / diff   |   diag / diff   |   diag (wide)    |   diag (wide)    |
+ * |            +-----------------+-----------------+-----------------+------------------+------------------+
+ * |            | 2 regs parallel | 4 regs parallel |                 |                  |                  |
+ * |         32 |  avx_b32_r2.h   |  avx_b32_r4.h   |   unsupported   |   unsupported    |   unsupported    |
+ * |            |   diag / diff   |   diag / diff   |                 |                  |                  |
+ * +------------+-----------------+-----------------+-----------------+------------------+------------------+
+ *
+ * The 128- and 256-cell wide variants no longer fit in the sixteen ymm
+ * registers; the compiler spills a part of the band to the stack.
  *
  * Complier flags:
  * To use macros in this header, the SIMD_BAND_WIDTH and the SIMD_BIT_WIDTH
@@ -55,7 +62,7 @@
 	#elif SIMD_BIT_WIDTH == 32
 		#include "avx_b32_r2.h"
 	#else
- 		#error "The SIMD_BIT_WIDTH must be 8 or 16 in the 16-cell wide AVX2 variants."
+ 		#error "The SIMD_BIT_WIDTH must be 8, 16, or 32 in the 16-cell wide AVX2 variants."
  	#endif
 #elif SIMD_BAND_WIDTH == 32
 	#if SIMD_BIT_WIDTH == 8
@@ -65,10 +72,28 @@
 	#elif SIMD_BIT_WIDTH == 32
 		#include "avx_b32_r4.h"
 	#else
- 		#error "The SIMD_BIT_WIDTH must be 8 or 16 in the 16-cell wide AVX2 variants."
+ 		#error "The SIMD_BIT_WIDTH must be 8, 16, or 32 in the 32-cell wide AVX2 variants."
+ 	#endif
+#elif SIMD_BAND_WIDTH == 64
+	#if SIMD_BIT_WIDTH == 16
+		#include "avx_b16_r4.h"
+	#else
+ 		#error "The SIMD_BIT_WIDTH must be 16 in the 64-cell wide AVX2 variants."
+ 	#endif
+#elif SIMD_BAND_WIDTH == 128
+	#if SIMD_BIT_WIDTH == 16
+		#include "avx_b16_r8.h"
+	#else
+ 		#error "The SIMD_BIT_WIDTH must be 16 in the 128-cell wide AVX2 variants."
+ 	#endif
+#elif SIMD_BAND_WIDTH == 256
+	#if SIMD_BIT_WIDTH == 16
+		#include "avx_b16_r16.h"
+	#else
+ 		#error "The SIMD_BIT_WIDTH must be 16 in the 256-cell wide AVX2 variants."
  	#endif
 #else 
- 	#error "The SIMD_BAND_WIDTH must be 16 or 32 in the AVX2 variants."
+ 	#error "The SIMD_BAND_WIDTH must be 16, 32, 64, 128, or 256 in the AVX2 variants."
 #endif
 
 
@@ -0,0 +1,562 @@
+
+/**
+ * @file avx_b16_r16.h
+ *
+ * @brief a header for macros of packed 16-bit AVX2 instructions.
+ *
+ * @detail
+ * This is a collection of wrapper macros of AVX2 SIMD intrinsics.
+ * Each macro corresponds to a set of several intrinsics defined in
+ * immintrin.h. The details of the intrinsics are found in the intel's
+ * website: https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+ * The required set of macros are documented in porting section of 
+ * README.md in the top directory of the library.
+ *
+ * 256 cells of 16-bit signed integers are held in 16 ymm registers.
+ *
+ * @sa avx.h
+ */
+#ifndef _AVX_B16_R16_H_INCLUDED
+#define _AVX_B16_R16_H_INCLUDED
+
+#include <immintrin.h>
+
+/**
+ * register declarations. 
+ */
+#define DECLARE_VEC_CELL(v)			__m256i v##1, v##2, v##3, v##4, v##5, v##6, v##7, v##8, v##9, v##10, v##11, v##12, v##13, v##14, v##15, v##16
+#define DECLARE_VEC_CELL_REG(v)		__m256i register v##1, v##2, v##3, v##4, v##5, v##6, v##7, v##8, v##9, v##10, v##11, v##12, v##13, v##14, v##15, v##16
+#define DECLARE_VEC_CHAR_REG(v)		__m256i register v##1, v##2, v##3, v##4, v##5, v##6, v##7, v##8
+
+/**
+ * substitution to cell vectors
+ */
+#define VEC_ASSIGN(a, b) { \
+	(a##1) = (b##1); (a##2) = (b##2); \
+	(a##3) = (b##3); (a##4) = (b##4); \
+	(a##5) = (b##5); (a##6) = (b##6); \
+	(a##7) = (b##7); (a##8) = (b##8); \
+	(a##9) = (b##9); (a##10) = (b##10); \
+	(a##11) = (b##11); (a##12) = (b##12); \
+	(a##13) = (b##13); (a##14) = (b##14); \
+	(a##15) = (b##15); (a##16) = (b##16); \
+}
+
+#define VEC_SET(v, i) { \
+	(v##1) = _mm256_set1_epi16(i); \
+	(v##2) = _mm256_set1_epi16(i); \
+	(v##3) = _mm256_set1_epi16(i); \
+	(v##4) = _mm256_set1_epi16(i); \
+	(v##5) = _mm256_set1_epi16(i); \
+	(v##6) = _mm256_set1_epi16(i); \
+	(v##7) = _mm256_set1_epi16(i); \
+	(v##8) = _mm256_set1_epi16(i); \
+	(v##9) = _mm256_set1_epi16(i); \
+	(v##10) = _mm256_set1_epi16(i); \
+	(v##11) = _mm256_set1_epi16(i); \
+	(v##12) = _mm256_set1_epi16(i); \
+	(v##13) = _mm256_set1_epi16(i); \
+	(v##14) = _mm256_set1_epi16(i); \
+	(v##15) = _mm256_set1_epi16(i); \
+	(v##16) = _mm256_set1_epi16(i); \
+}
+
+#define VEC_SETZERO(v) { \
+	(v##1) = _mm256_setzero_si256(); \
+	(v##2) = _mm256_setzero_si256(); \
+	(v##3) = _mm256_setzero_si256(); \
+	(v##4) = _mm256_setzero_si256(); \
+	(v##5) = _mm256_setzero_si256(); \
+	(v##6) = _mm256_setzero_si256(); \
+	(v##7) = _mm256_setzero_si256(); \
+	(v##8) = _mm256_setzero_si256(); \
+	(v##9) = _mm256_setzero_si256(); \
+	(v##10) = _mm256_setzero_si256(); \
+	(v##11) = _mm256_setzero_si256(); \
+	(v##12) = _mm256_setzero_si256(); \
+	(v##13) = _mm256_setzero_si256(); \
+	(v##14) = _mm256_setzero_si256(); \
+	(v##15) = _mm256_setzero_si256(); \
+	(v##16) = _mm256_setzero_si256(); \
+}
+
+#define VEC_SETONES(v) { \
+	(v##1) = _mm256_set1_epi8(0xff); \
+	(v##2) = _mm256_set1_epi8(0xff); \
+	(v##3) = _mm256_set1_epi8(0xff); \
+	(v##4) = _mm256_set1_epi8(0xff); \
+	(v##5) = _mm256_set1_epi8(0xff); \
+	(v##6) = _mm256_set1_epi8(0xff); \
+	(v##7) = _mm256_set1_epi8(0xff); \
+	(v##8) = _mm256_set1_epi8(0xff); \
+	(v##9) = _mm256_set1_epi8(0xff); \
+	(v##10) = _mm256_set1_epi8(0xff); \
+	(v##11) = _mm256_set1_epi8(0xff); \
+	(v##12) = _mm256_set1_epi8(0xff); \
+	(v##13) = _mm256_set1_epi8(0xff); \
+	(v##14) = _mm256_set1_epi8(0xff); \
+	(v##15) = _mm256_set1_epi8(0xff); \
+	(v##16) = _mm256_set1_epi8(0xff); \
+}
+
+/**
+ * substitution to char vectors
+ */
+#define VEC_CHAR_SETZERO(v) { \
+	(v##1) = _mm256_setzero_si256(); \
+	(v##2) = _mm256_setzero_si256(); \
+	(v##3) = _mm256_setzero_si256(); \
+	(v##4) = _mm256_setzero_si256(); \
+	(v##5) = _mm256_setzero_si256(); \
+	(v##6) = _mm256_setzero_si256(); \
+	(v##7) = _mm256_setzero_si256(); \
+	(v##8) = _mm256_setzero_si256(); \
+}
+
+#define VEC_CHAR_SETONES(v) { \
+	(v##1) = _mm256_set1_epi8(0xff); \
+	(v##2) = _mm256_set1_epi8(0xff); \
+	(v##3) = _mm256_set1_epi8(0xff); \
+	(v##4) = _mm256_set1_epi8(0xff); \
+	(v##5) = _mm256_set1_epi8(0xff); \
+	(v##6) = _mm256_set1_epi8(0xff); \
+	(v##7) = _mm256_set1_epi8(0xff); \
+	(v##8) = _mm256_set1_epi8(0xff); \
+}
+
+/**
+ * special substitution macros
+ */
+#define VEC_SET_LHALF(v, i) { \
+	(v##1) = _mm256_set1_epi16(i); \
+	(v##2) = _mm256_set1_epi16(i); \
+	(v##3) = _mm256_set1_epi16(i); \
+	(v##4) = _mm256_set1_epi16(i); \
+	(v##5) = _mm256_set1_epi16(i); \
+	(v##6) = _mm256_set1_epi16(i); \
+	(v##7) = _mm256_set1_epi16(i); \
+	(v##8) = _mm256_set1_epi16(i); \
+	(v##9) = _mm256_setzero_si256(); \
+	(v##10) = _mm256_setzero_si256(); \
+	(v##11) = _mm256_setzero_si256(); \
+	(v##12) = _mm256_setzero_si256(); \
+	(v##13) = _mm256_setzero_si256(); \
+	(v##14) = _mm256_setzero_si256(); \
+	(v##15) = _mm256_setzero_si256(); \
+	(v##16) = _mm256_setzero_si256(); \
+}
+
+#define VEC_SET_UHALF(v, i) { \
+	(v##1) = _mm256_setzero_si256(); \
+	(v##2) = _mm256_setzero_si256(); \
+	(v##3) = _mm256_setzero_si256(); \
+	(v##4) = _mm256_setzero_si256(); \
+	(v##5) = _mm256_setzero_si256(); \
+	(v##6) = _mm256_setzero_si256(); \
+	(v##7) = _mm256_setzero_si256(); \
+	(v##8) = _mm256_setzero_si256(); \
+	(v##9) = _mm256_set1_epi16(i); \
+	(v##10) = _mm256_set1_epi16(i); \
+	(v##11) = _mm256_set1_epi16(i); \
+	(v##12) = _mm256_set1_epi16(i); \
+	(v##13) = _mm256_set1_epi16(i); \
+	(v##14) = _mm256_set1_epi16(i); \
+	(v##15) = _mm256_set1_epi16(i); \
+	(v##16) = _mm256_set1_epi16(i); \
+}
+
+#define VEC_SETF_MSB(v) { \
+	VEC_SETZERO(v); VEC_INSERT_MSB((v), 0xf0); \
+}
+
+#define VEC_SETF_LSB(v) { \
+	VEC_SETZERO(v); VEC_INSERT_LSB((v), 0x0f); \
+}
+
+/**
+ * insertion and extraction macros
+ */
+#define VEC_INSERT_MSB(v, a) { \
+	(v##16) = _mm256_inserti128_si256( \
+		(v##16), \
+		_mm_insert_epi16( \
+			_mm256_extracti128_si256((v##16), 1), (a), 7), \
+		1); \
+}
+
+#define VEC_INSERT_LSB(v, a) { \
+	(v##1) = _mm256_inserti128_si256( \
+		(v##1), \
+		_mm_insert_epi16( \
+			_mm256_extracti128_si256((v##1), 0), (a), 0), \
+		0); \
+}
+
+#define VEC_MSB(v)		( (signed short)_mm_extract_epi16(_mm256_extracti128_si256((v##16), 1), 7) )
+#define VEC_LSB(v)		( (signed short)_mm_extract_epi16(_mm256_extracti128_si256((v##1), 0), 0) )
+#define VEC_CENTER(v)	( (signed short)_mm_extract_epi16(_mm256_extracti128_si256((v##9), 0), 0) )
+
+/**
+ * arithmetic and logic operations
+ */
+#define VEC_OR(a, b, c) { \
+	(a##1) = _mm256_or_si256((b##1), (c##1)); \
+	(a##2) = _mm256_or_si256((b##2), (c##2)); \
+	(a##3) = _mm256_or_si256((b##3), (c##3)); \
+	(a##4) = _mm256_or_si256((b##4), (c##4)); \
+	(a##5) = _mm256_or_si256((b##5), (c##5)); \
+	(a##6) = _mm256_or_si256((b##6), (c##6)); \
+	(a##7) = _mm256_or_si256((b##7), (c##7)); \
+	(a##8) = _mm256_or_si256((b##8), (c##8)); \
+	(a##9) = _mm256_or_si256((b##9), (c##9)); \
+	(a##10) = _mm256_or_si256((b##10), (c##10)); \
+	(a##11) = _mm256_or_si256((b##11), (c##11)); \
+	(a##12) = _mm256_or_si256((b##12), (c##12)); \
+	(a##13) = _mm256_or_si256((b##13), (c##13)); \
+	(a##14) = _mm256_or_si256((b##14), (c##14)); \
+	(a##15) = _mm256_or_si256((b##15), (c##15)); \
+	(a##16) = _mm256_or_si256((b##16), (c##16)); \
+}
+
+#define VEC_ADD(a, b, c) { \
+	(a##1) = _mm256_adds_epi16((b##1), (c##1)); \
+	(a##2) = _mm256_adds_epi16((b##2), (c##2)); \
+	(a##3) = _mm256_adds_epi16((b##3), (c##3)); \
+	(a##4) = _mm256_adds_epi16((b##4), (c##4)); \
+	(a##5) = _mm256_adds_epi16((b##5), (c##5)); \
+	(a##6) = _mm256_adds_epi16((b##6), (c##6)); \
+	(a##7) = _mm256_adds_epi16((b##7), (c##7)); \
+	(a##8) = _mm256_adds_epi16((b##8), (c##8)); \
+	(a##9) = _mm256_adds_epi16((b##9), (c##9)); \
+	(a##10) = _mm256_adds_epi16((b##10), (c##10)); \
+	(a##11) = _mm256_adds_epi16((b##11), (c##11)); \
+	(a##12) = _mm256_adds_epi16((b##12), (c##12)); \
+	(a##13) = _mm256_adds_epi16((b##13), (c##13)); \
+	(a##14) = _mm256_adds_epi16((b##14), (c##14)); \
+	(a##15) = _mm256_adds_epi16((b##15), (c##15)); \
+	(a##16) = _mm256_adds_epi16((b##16), (c##16)); \
+}
+
+#define VEC_ADDS(a, b, c) { \
+	(a##1) = _mm256_adds_epu16((b##1), (c##1)); \
+	(a##2) = _mm256_adds_epu16((b##2), (c##2)); \
+	(a##3) = _mm256_adds_epu16((b##3), (c##3)); \
+	(a##4) = _mm256_adds_epu16((b##4), (c##4)); \
+	(a##5) = _mm256_adds_epu16((b##5), (c##5)); \
+	(a##6) = _mm256_adds_epu16((b##6), (c##6)); \
+	(a##7) = _mm256_adds_epu16((b##7), (c##7)); \
+	(a##8) = _mm256_adds_epu16((b##8), (c##8)); \
+	(a##9) = _mm256_adds_epu16((b##9), (c##9)); \
+	(a##10) = _mm256_adds_epu16((b##10), (c##10)); \
+	(a##11) = _mm256_adds_epu16((b##11), (c##11)); \
+	(a##12) = _mm256_adds_epu16((b##12), (c##12)); \
+	(a##13) = _mm256_adds_epu16((b##13), (c##13)); \
+	(a##14) = _mm256_adds_epu16((b##14), (c##14)); \
+	(a##15) = _mm256_adds_epu16((b##15), (c##15)); \
+	(a##16) = _mm256_adds_epu16((b##16), (c##16)); \
+}
+
+#define VEC_SUB(a, b, c) { \
+	(a##1) = _mm256_subs_epi16((b##1), (c##1)); \
+	(a##2) = _mm256_subs_epi16((b##2), (c##2)); \
+	(a##3) = _mm256_subs_epi16((b##3), (c##3)); \
+	(a##4) = _mm256_subs_epi16((b##4), (c##4)); \
+	(a##5) = _mm256_subs_epi16((b##5), (c##5)); \
+	(a##6) = _mm256_subs_epi16((b##6), (c##6)); \
+	(a##7) = _mm256_subs_epi16((b##7), (c##7)); \
+	(a##8) = _mm256_subs_epi16((b##8), (c##8)); \
+	(a##9) = _mm256_subs_epi16((b##9), (c##9)); \
+	(a##10) = _mm256_subs_epi16((b##10), (c##10)); \
+	(a##11) = _mm256_subs_epi16((b##11), (c##11)); \
+	(a##12) = _mm256_subs_epi16((b##12), (c##12)); \
+	(a##13) = _mm256_subs_epi16((b##13), (c##13)); \
+	(a##14) = _mm256_subs_epi16((b##14), (c##14)); \
+	(a##15) = _mm256_subs_epi16((b##15), (c##15)); \
+	(a##16) = _mm256_subs_epi16((b##16), (c##16)); \
+}
+
+#define VEC_SUBS(a, b, c) { \
+	(a##1) = _mm256_subs_epu16((b##1), (c##1)); \
+	(a##2) = _mm256_subs_epu16((b##2), (c##2)); \
+	(a##3) = _mm256_subs_epu16((b##3), (c##3)); \
+	(a##4) = _mm256_subs_epu16((b##4), (c##4)); \
+	(a##5) = _mm256_subs_epu16((b##5), (c##5)); \
+	(a##6) = _mm256_subs_epu16((b##6), (c##6)); \
+	(a##7) = _mm256_subs_epu16((b##7), (c##7)); \
+	(a##8) = _mm256_subs_epu16((b##8), (c##8)); \
+	(a##9) = _mm256_subs_epu16((b##9), (c##9)); \
+	(a##10) = _mm256_subs_epu16((b##10), (c##10)); \
+	(a##11) = _mm256_subs_epu16((b##11), (c##11)); \
+	(a##12) = _mm256_subs_epu16((b##12), (c##12)); \
+	(a##13) = _mm256_subs_epu16((b##13), (c##13)); \
+	(a##14) = _mm256_subs_epu16((b##14), (c##14)); \
+	(a##15) = _mm256_subs_epu16((b##15), (c##15)); \
+	(a##16) = _mm256_subs_epu16((b##16), (c##16)); \
+}
+
+#define VEC_MAX(a, b, c) { \
+	(a##1) = _mm256_max_epi16((b##1), (c##1)); \
+	(a##2) = _mm256_max_epi16((b##2), (c##2)); \
+	(a##3) = _mm256_max_epi16((b##3), (c##3)); \
+	(a##4) = _mm256_max_epi16((b##4), (c##4)); \
+	(a##5) = _mm256_max_epi16((b##5), (c##5)); \
+	(a##6) = _mm256_max_epi16((b##6), (c##6)); \
+	(a##7) = _mm256_max_epi16((b##7), (c##7)); \
+	(a##8) = _mm256_max_epi16((b##8), (c##8)); \
+	(a##9) = _mm256_max_epi16((b##9), (c##9)); \
+	(a##10) = _mm256_max_epi16((b##10), (c##10)); \
+	(a##11) = _mm256_max_epi16((b##11), (c##11)); \
+	(a##12) = _mm256_max_epi16((b##12), (c##12)); \
+	(a##13) = _mm256_max_epi16((b##13), (c##13)); \
+	(a##14) = _mm256_max_epi16((b##14), (c##14)); \
+	(a##15) = _mm256_max_epi16((b##15), (c##15)); \
+	(a##16) = _mm256_max_epi16((b##16), (c##16)); \
+}
+
+#define VEC_MIN(a, b, c) { \
+	(a##1) = _mm256_min_epi16((b##1), (c##1)); \
+	(a##2) = _mm256_min_epi16((b##2), (c##2)); \
+	(a##3) = _mm256_min_epi16((b##3), (c##3)); \
+	(a##4) = _mm256_min_epi16((b##4), (c##4)); \
+	(a##5) = _mm256_min_epi16((b##5), (c##5)); \
+	(a##6) = _mm256_min_epi16((b##6), (c##6)); \
+	(a##7) = _mm256_min_epi16((b##7), (c##7)); \
+	(a##8) = _mm256_min_epi16((b##8), (c##8)); \
+	(a##9) = _mm256_min_epi16((b##9), (c##9)); \
+	(a##10) = _mm256_min_epi16((b##10), (c##10)); \
+	(a##11) = _mm256_min_epi16((b##11), (c##11)); \
+	(a##12) = _mm256_min_epi16((b##12), (c##12)); \
+	(a##13) = _mm256_min_epi16((b##13), (c##13)); \
+	(a##14) = _mm256_min_epi16((b##14), (c##14)); \
+	(a##15) = _mm256_min_epi16((b##15), (c##15)); \
+	(a##16) = _mm256_min_epi16((b##16), (c##16)); \
+}
+
+#define VEC_HMAX(a, b) { \
+	(b##1) = _mm256_max_epi16((b##1), (b##9)); \
+	(b##2) = _mm256_max_epi16((b##2), (b##10)); \
+	(b##3) = _mm256_max_epi16((b##3), (b##11)); \
+	(b##4) = _mm256_max_epi16((b##4), (b##12)); \
+	(b##5) = _mm256_max_epi16((b##5), (b##13)); \
+	(b##6) = _mm256_max_epi16((b##6), (b##14)); \
+	(b##7) = _mm256_max_epi16((b##7), (b##15)); \
+	(b##8) = _mm256_max_epi16((b##8), (b##16)); \
+	(b##1) = _mm256_max_epi16((b##1), (b##5)); \
+	(b##2) = _mm256_max_epi16((b##2), (b##6)); \
+	(b##3) = _mm256_max_epi16((b##3), (b##7)); \
+	(b##4) = _mm256_max_epi16((b##4), (b##8)); \
+	(b##1) = _mm256_max_epi16((b##1), (b##3)); \
+	(b##2) = _mm256_max_epi16((b##2), (b##4)); \
+	(b##1) = _mm256_max_epi16((b##1), (b##2)); \
+	__m128i tmp = _mm_max_epi16(_mm256_castsi256_si128(b##1), _mm256_extracti128_si256((b##1), 1)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 8)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 4)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 2)); \
+	(a) = (signed short)_mm_extract_epi16(tmp, 0); \
+}
+
+/**
+ * shift operations
+ */
+#define VEC_SHIFT_R(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##2), 0x21); \
+	__m256i tmp2 = _mm256_permute2x128_si256((a##2), (a##3), 0x21); \
+	__m256i tmp3 = _mm256_permute2x128_si256((a##3), (a##4), 0x21); \
+	__m256i tmp4 = _mm256_permute2x128_si256((a##4), (a##5), 0x21); \
+	__m256i tmp5 = _mm256_permute2x128_si256((a##5), (a##6), 0x21); \
+	__m256i tmp6 = _mm256_permute2x128_si256((a##6), (a##7), 0x21); \
+	__m256i tmp7 = _mm256_permute2x128_si256((a##7), (a##8), 0x21); \
+	__m256i tmp8 = _mm256_permute2x128_si256((a##8), (a##9), 0x21); \
+	__m256i tmp9 = _mm256_permute2x128_si256((a##9), (a##10), 0x21); \
+	__m256i tmp10 = _mm256_permute2x128_si256((a##10), (a##11), 0x21); \
+	__m256i tmp11 = _mm256_permute2x128_si256((a##11), (a##12), 0x21); \
+	__m256i tmp12 = _mm256_permute2x128_si256((a##12), (a##13), 0x21); \
+	__m256i tmp13 = _mm256_permute2x128_si256((a##13), (a##14), 0x21); \
+	__m256i tmp14 = _mm256_permute2x128_si256((a##14), (a##15), 0x21); \
+	__m256i tmp15 = _mm256_permute2x128_si256((a##15), (a##16), 0x21); \
+	__m256i tmp16 = _mm256_permute2x128_si256((a##16), (a##16), 0x81); \
+	(a##1) = _mm256_alignr_epi8(tmp1, (a##1), 2); \
+	(a##2) = _mm256_alignr_epi8(tmp2, (a##2), 2); \
+	(a##3) = _mm256_alignr_epi8(tmp3, (a##3), 2); \
+	(a##4) = _mm256_alignr_epi8(tmp4, (a##4), 2); \
+	(a##5) = _mm256_alignr_epi8(tmp5, (a##5), 2); \
+	(a##6) = _mm256_alignr_epi8(tmp6, (a##6), 2); \
+	(a##7) = _mm256_alignr_epi8(tmp7, (a##7), 2); \
+	(a##8) = _mm256_alignr_epi8(tmp8, (a##8), 2); \
+	(a##9) = _mm256_alignr_epi8(tmp9, (a##9), 2); \
+	(a##10) = _mm256_alignr_epi8(tmp10, (a##10), 2); \
+	(a##11) = _mm256_alignr_epi8(tmp11, (a##11), 2); \
+	(a##12) = _mm256_alignr_epi8(tmp12, (a##12), 2); \
+	(a##13) = _mm256_alignr_epi8(tmp13, (a##13), 2); \
+	(a##14) = _mm256_alignr_epi8(tmp14, (a##14), 2); \
+	(a##15) = _mm256_alignr_epi8(tmp15, (a##15), 2); \
+	(a##16) = _mm256_alignr_epi8(tmp16, (a##16), 2); \
+}
+
+#define VEC_SHIFT_L(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##1), 0x08); \
+	__m256i tmp2 = _mm256_permute2x128_si256((a##2), (a##1), 0x03); \
+	__m256i tmp3 = _mm256_permute2x128_si256((a##3), (a##2), 0x03); \
+	__m256i tmp4 = _mm256_permute2x128_si256((a##4), (a##3), 0x03); \
+	__m256i tmp5 = _mm256_permute2x128_si256((a##5), (a##4), 0x03); \
+	__m256i tmp6 = _mm256_permute2x128_si256((a##6), (a##5), 0x03); \
+	__m256i tmp7 = _mm256_permute2x128_si256((a##7), (a##6), 0x03); \
+	__m256i tmp8 = _mm256_permute2x128_si256((a##8), (a##7), 0x03); \
+	__m256i tmp9 = _mm256_permute2x128_si256((a##9), (a##8), 0x03); \
+	__m256i tmp10 = _mm256_permute2x128_si256((a##10), (a##9), 0x03); \
+	__m256i tmp11 = _mm256_permute2x128_si256((a##11), (a##10), 0x03); \
+	__m256i tmp12 = _mm256_permute2x128_si256((a##12), (a##11), 0x03); \
+	__m256i tmp13 = _mm256_permute2x128_si256((a##13), (a##12), 0x03); \
+	__m256i tmp14 = _mm256_permute2x128_si256((a##14), (a##13), 0x03); \
+	__m256i tmp15 = _mm256_permute2x128_si256((a##15), (a##14), 0x03); \
+	__m256i tmp16 = _mm256_permute2x128_si256((a##16), (a##15), 0x03); \
+	(a##1) = _mm256_alignr_epi8((a##1), tmp1, 14); \
+	(a##2) = _mm256_alignr_epi8((a##2), tmp2, 14); \
+	(a##3) = _mm256_alignr_epi8((a##3), tmp3, 14); \
+	(a##4) = _mm256_alignr_epi8((a##4), tmp4, 14); \
+	(a##5) = _mm256_alignr_epi8((a##5), tmp5, 14); \
+	(a##6) = _mm256_alignr_epi8((a##6), tmp6, 14); \
+	(a##7) = _mm256_alignr_epi8((a##7), tmp7, 14); \
+	(a##8) = _mm256_alignr_epi8((a##8), tmp8, 14); \
+	(a##9) = _mm256_alignr_epi8((a##9), tmp9, 14); \
+	(a##10) = _mm256_alignr_epi8((a##10), tmp10, 14); \
+	(a##11) = _mm256_alignr_epi8((a##11), tmp11, 14); \
+	(a##12) = _mm256_alignr_epi8((a##12), tmp12, 14); \
+	(a##13) = _mm256_alignr_epi8((a##13), tmp13, 14); \
+	(a##14) = _mm256_alignr_epi8((a##14), tmp14, 14); \
+	(a##15) = _mm256_alignr_epi8((a##15), tmp15, 14); \
+	(a##16) = _mm256_alignr_epi8((a##16), tmp16, 14); \
+}
+
+/**
+ * compare and select
+ */
+#define VEC_COMPARE(a, b, c) { \
+	__m256i mask1 = _mm256_cmpeq_epi8((b##1), (c##1)); \
+	__m256i mask2 = _mm256_cmpeq_epi8((b##2), (c##2)); \
+	__m256i mask3 = _mm256_cmpeq_epi8((b##3), (c##3)); \
+	__m256i mask4 = _mm256_cmpeq_epi8((b##4), (c##4)); \
+	__m256i mask5 = _mm256_cmpeq_epi8((b##5), (c##5)); \
+	__m256i mask6 = _mm256_cmpeq_epi8((b##6), (c##6)); \
+	__m256i mask7 = _mm256_cmpeq_epi8((b##7), (c##7)); \
+	__m256i mask8 = _mm256_cmpeq_epi8((b##8), (c##8)); \
+	(a##1) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask1, 0)); \
+	(a##2) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask1, 1)); \
+	(a##3) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask2, 0)); \
+	(a##4) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask2, 1)); \
+	(a##5) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask3, 0)); \
+	(a##6) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask3, 1)); \
+	(a##7) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask4, 0)); \
+	(a##8) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask4, 1)); \
+	(a##9) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask5, 0)); \
+	(a##10) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask5, 1)); \
+	(a##11) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask6, 0)); \
+	(a##12) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask6, 1)); \
+	(a##13) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask7, 0)); \
+	(a##14) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask7, 1)); \
+	(a##15) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask8, 0)); \
+	(a##16) = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(mask8, 1)); \
+}
+
+#define VEC_SELECT(a, b, c, d) { \
+	(a##1) = _mm256_blendv_epi8((b##1), (c##1), (d##1)); \
+	(a##2) = _mm256_blendv_epi8((b##2), (c##2), (d##2)); \
+	(a##3) = _mm256_blendv_epi8((b##3), (c##3), (d##3)); \
+	(a##4) = _mm256_blendv_epi8((b##4), (c##4), (d##4)); \
+	(a##5) = _mm256_blendv_epi8((b##5), (c##5), (d##5)); \
+	(a##6) = _mm256_blendv_epi8((b##6), (c##6), (d##6)); \
+	(a##7) = _mm256_blendv_epi8((b##7), (c##7), (d##7)); \
+	(a##8) = _mm256_blendv_epi8((b##8), (c##8), (d##8)); \
+	(a##9) = _mm256_blendv_epi8((b##9), (c##9), (d##9)); \
+	(a##10) = _mm256_blendv_epi8((b##10), (c##10), (d##10)); \
+	(a##11) = _mm256_blendv_epi8((b##11), (c##11), (d##11)); \
+	(a##12) = _mm256_blendv_epi8((b##12), (c##12), (d##12)); \
+	(a##13) = _mm256_blendv_epi8((b##13), (c##13), (d##13)); \
+	(a##14) = _mm256_blendv_epi8((b##14), (c##14), (d##14)); \
+	(a##15) = _mm256_blendv_epi8((b##15), (c##15), (d##15)); \
+	(a##16) = _mm256_blendv_epi8((b##16), (c##16), (d##16)); \
+}
+
+/**
+ * load and store operations
+ */
+#define VEC_STORE(p, v) { \
+	_mm256_store_si256((__m256i *)(p), v##1); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##2); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##3); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##4); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##5); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##6); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##7); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##8); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##9); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##10); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##11); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##12); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##13); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##14); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##15); p += sizeof(__m256i); \
+	_mm256_store_si256((__m256i *)(p), v##16); p += sizeof(__m256i); \
+}
+
+/**
+ * char vector operations
+ */
+#define VEC_CHAR_SHIFT_R(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##2), 0x21); \
+	__m256i tmp2 = _mm256_permute2x128_si256((a##2), (a##3), 0x21); \
+	__m256i tmp3 = _mm256_permute2x128_si256((a##3), (a##4), 0x21); \
+	__m256i tmp4 = _mm256_permute2x128_si256((a##4), (a##5), 0x21); \
+	__m256i tmp5 = _mm256_permute2x128_si256((a##5), (a##6), 0x21); \
+	__m256i tmp6 = _mm256_permute2x128_si256((a##6), (a##7), 0x21); \
+	__m256i tmp7 = _mm256_permute2x128_si256((a##7), (a##8), 0x21); \
+	__m256i tmp8 = _mm256_permute2x128_si256((a##8), (a##8), 0x81); \
+	(a##1) = _mm256_alignr_epi8(tmp1, (a##1), 1); \
+	(a##2) = _mm256_alignr_epi8(tmp2, (a##2), 1); \
+	(a##3) = _mm256_alignr_epi8(tmp3, (a##3), 1); \
+	(a##4) = _mm256_alignr_epi8(tmp4, (a##4), 1); \
+	(a##5) = _mm256_alignr_epi8(tmp5, (a##5), 1); \
+	(a##6) = _mm256_alignr_epi8(tmp6, (a##6), 1); \
+	(a##7) = _mm256_alignr_epi8(tmp7, (a##7), 1); \
+	(a##8) = _mm256_alignr_epi8(tmp8, (a##8), 1); \
+}
+
+#define VEC_CHAR_SHIFT_L(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##1), 0x08); \
+	__m256i tmp2 = _mm256_permute2x128_si256((a##2), (a##1), 0x03); \
+	__m256i tmp3 = _mm256_permute2x128_si256((a##3), (a##2), 0x03); \
+	__m256i tmp4 = _mm256_permute2x128_si256((a##4), (a##3), 0x03); \
+	__m256i tmp5 = _mm256_permute2x128_si256((a##5), (a##4), 0x03); \
+	__m256i tmp6 = _mm256_permute2x128_si256((a##6), (a##5), 0x03); \
+	__m256i tmp7 = _mm256_permute2x128_si256((a##7), (a##6), 0x03); \
+	__m256i tmp8 = _mm256_permute2x128_si256((a##8), (a##7), 0x03); \
+	(a##1) = _mm256_alignr_epi8((a##1), tmp1, 15); \
+	(a##2) = _mm256_alignr_epi8((a##2), tmp2, 15); \
+	(a##3) = _mm256_alignr_epi8((a##3), tmp3, 15); \
+	(a##4) = _mm256_alignr_epi8((a##4), tmp4, 15); \
+	(a##5) = _mm256_alignr_epi8((a##5), tmp5, 15); \
+	(a##6) = _mm256_alignr_epi8((a##6), tmp6, 15); \
+	(a##7) = _mm256_alignr_epi8((a##7), tmp7, 15); \
+	(a##8) = _mm256_alignr_epi8((a##8), tmp8, 15); \
+}
+
+#define VEC_CHAR_INSERT_MSB(x, y) { \
+	(x##8) = _mm256_inserti128_si256( \
+		(x##8), \
+		_mm_insert_epi8( \
+			_mm256_extracti128_si256((x##8), 1), (y), 15), \
+		1); \
+}
+
+#define VEC_CHAR_INSERT_LSB(x, y) { \
+	(x##1) = _mm256_inserti128_si256( \
+		(x##1), \
+		_mm_insert_epi8( \
+			_mm256_extracti128_si256((x##1), 0), (y), 0), \
+		0); \
+}
+
+#endif /* #ifndef _AVX_B16_R16_H_INCLUDED */
+/**
+ * end of avx_b16_r16.h
+ */
@@ -141,6 +141,15 @@
 	(a##2) = _mm256_min_epi16((b##2), (c##2)); \
 }
 
+#define VEC_HMAX(a, b) { \
+	(b##1) = _mm256_max_epi16((b##1), (b##2)); \
+	__m128i tmp = _mm_max_epi16(_mm256_castsi256_si128(b##1), _mm256_extracti128_si256((b##1), 1)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 8)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 4)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 2)); \
+	(a) = (signed short)_mm_extract_epi16(tmp, 0); \
+}
+
 /**
  * shift operations
  *
@@ -0,0 +1,206 @@
+
+/**
+ * @file avx_b8_r1.h
+ *
+ * @brief a header for macros of packed 8-bit AVX2 instructions.
+ *
+ * @detail
+ * This is a collection of wrapper macros of AVX2 SIMD intrinsics.
+ * Each macro corresponds to a set of several intrinsics defined in
+ * immintrin.h. The details of the intrinsics are found in the intel's
+ * website: https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+ * The required set of macros are documented in porting section of 
+ * README.md in the top directory of the library.
+ *
+ * 32 cells of 8-bit signed integers are held in 1 ymm register.
+ *
+ * @sa avx.h
+ */
+#ifndef _AVX_B8_R1_H_INCLUDED
+#define _AVX_B8_R1_H_INCLUDED
+
+#include <immintrin.h>
+
+/**
+ * register declarations. 
+ */
+#define DECLARE_VEC_CELL(v)			__m256i v##1
+#define DECLARE_VEC_CELL_REG(v)		__m256i register v##1
+#define DECLARE_VEC_CHAR_REG(v)		__m256i register v##1
+
+/**
+ * substitution to cell vectors
+ */
+#define VEC_ASSIGN(a, b) { \
+	(a##1) = (b##1); \
+}
+
+#define VEC_SET(v, i) { \
+	(v##1) = _mm256_set1_epi8(i); \
+}
+
+#define VEC_SETZERO(v) { \
+	(v##1) = _mm256_setzero_si256(); \
+}
+
+#define VEC_SETONES(v) { \
+	(v##1) = _mm256_set1_epi8(0xff); \
+}
+
+/**
+ * substitution to char vectors
+ */
+#define VEC_CHAR_SETZERO(v) { \
+	(v##1) = _mm256_setzero_si256(); \
+}
+
+#define VEC_CHAR_SETONES(v) { \
+	(v##1) = _mm256_set1_epi8(0xff); \
+}
+
+/**
+ * special substitution macros
+ */
+#define VEC_SET_LHALF(v, i) { \
+	(v##1) = _mm256_permute2x128_si256(_mm256_set1_epi8(i), _mm256_set1_epi8(i), 0x80); \
+}
+
+#define VEC_SET_UHALF(v, i) { \
+	(v##1) = _mm256_permute2x128_si256(_mm256_set1_epi8(i), _mm256_set1_epi8(i), 0x08); \
+}
+
+#define VEC_SETF_MSB(v) { \
+	VEC_SETZERO(v); VEC_INSERT_MSB((v), 0xf0); \
+}
+
+#define VEC_SETF_LSB(v) { \
+	VEC_SETZERO(v); VEC_INSERT_LSB((v), 0x0f); \
+}
+
+/**
+ * insertion and extraction macros
+ */
+#define VEC_INSERT_MSB(v, a) { \
+	(v##1) = _mm256_inserti128_si256( \
+		(v##1), \
+		_mm_insert_epi8( \
+			_mm256_extracti128_si256((v##1), 1), (a), 15), \
+		1); \
+}
+
+#define VEC_INSERT_LSB(v, a) { \
+	(v##1) = _mm256_inserti128_si256( \
+		(v##1), \
+		_mm_insert_epi8( \
+			_mm256_extracti128_si256((v##1), 0), (a), 0), \
+		0); \
+}
+
+#define VEC_MSB(v)		( (signed char)_mm_extract_epi8(_mm256_extracti128_si256((v##1), 1), 15) )
+#define VEC_LSB(v)		( (signed char)_mm_extract_epi8(_mm256_extracti128_si256((v##1), 0), 0) )
+#define VEC_CENTER(v)	( (signed char)_mm_extract_epi8(_mm256_extracti128_si256((v##1), 1), 0) )
+
+/**
+ * arithmetic and logic operations
+ */
+#define VEC_OR(a, b, c) { \
+	(a##1) = _mm256_or_si256((b##1), (c##1)); \
+}
+
+#define VEC_ADD(a, b, c) { \
+	(a##1) = _mm256_adds_epi8((b##1), (c##1)); \
+}
+
+#define VEC_ADDS(a, b, c) { \
+	(a##1) = _mm256_adds_epu8((b##1), (c##1)); \
+}
+
+#define VEC_SUB(a, b, c) { \
+	(a##1) = _mm256_subs_epi8((b##1), (c##1)); \
+}
+
+#define VEC_SUBS(a, b, c) { \
+	(a##1) = _mm256_subs_epu8((b##1), (c##1)); \
+}
+
+#define VEC_MAX(a, b, c) { \
+	(a##1) = _mm256_max_epi8((b##1), (c##1)); \
+}
+
+#define VEC_MIN(a, b, c) { \
+	(a##1) = _mm256_min_epi8((b##1), (c##1)); \
+}
+
+#define VEC_HMAX(a, b) { \
+	__m128i tmp = _mm_max_epi8(_mm256_castsi256_si128(b##1), _mm256_extracti128_si256((b##1), 1)); \
+	tmp = _mm_max_epi8(tmp, _mm_srli_si128(tmp, 8)); \
+	tmp = _mm_max_epi8(tmp, _mm_srli_si128(tmp, 4)); \
+	tmp = _mm_max_epi8(tmp, _mm_srli_si128(tmp, 2)); \
+	tmp = _mm_max_epi8(tmp, _mm_srli_si128(tmp, 1)); \
+	(a) = (signed char)_mm_extract_epi8(tmp, 0); \
+}
+
+/**
+ * shift operations
+ */
+#define VEC_SHIFT_R(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##1), 0x81); \
+	(a##1) = _mm256_alignr_epi8(tmp1, (a##1), 1); \
+}
+
+#define VEC_SHIFT_L(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##1), 0x08); \
+	(a##1) = _mm256_alignr_epi8((a##1), tmp1, 15); \
+}
+
+/**
+ * compare and select
+ */
+#define VEC_COMPARE(a, b, c) { \
+	(a##1) = _mm256_cmpeq_epi8((b##1), (c##1)); \
+}
+
+#define VEC_SELECT(a, b, c, d) { \
+	(a##1) = _mm256_blendv_epi8((b##1), (c##1), (d##1)); \
+}
+
+/**
+ * load and store operations
+ */
+#define VEC_STORE(p, v) { \
+	_mm256_store_si256((__m256i *)(p), v##1); p += sizeof(__m256i); \
+}
+
+/**
+ * char vector operations
+ */
+#define VEC_CHAR_SHIFT_R(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##1), 0x81); \
+	(a##1) = _mm256_alignr_epi8(tmp1, (a##1), 1); \
+}
+
+#define VEC_CHAR_SHIFT_L(a) { \
+	__m256i tmp1 = _mm256_permute2x128_si256((a##1), (a##1), 0x08); \
+	(a##1) = _mm256_alignr_epi8((a##1), tmp1, 15); \
+}
+
+#define VEC_CHAR_INSERT_MSB(x, y) { \
+	(x##1) = _mm256_inserti128_si256( \
+		(x##1), \
+		_mm_insert_epi8( \
+			_mm256_extracti128_si256((x##1), 1), (y), 15), \
+		1); \
+}
+
+#define VEC_CHAR_INSERT_LSB(x, y) { \
+	(x##1) = _mm256_inserti128_si256( \
+		(x##1), \
+		_mm_insert_epi8( \
+			_mm256_extracti128_si256((x##1), 0), (y), 0), \
+		0); \
+}
+
+#endif /* #ifndef _AVX_B8_R1_H_INCLUDED */
+/**
+ * end of avx_b8_r1.h
+ */
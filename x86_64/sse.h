@@ -22,18 +22,25 @@
  * (e.g. 2 regs parallel) indicates the composition of a band, the middle of the
  * cell is the name of the header, and the bottom is an algorithmic capability of
  * the header.
- * +------------------------------------------------+
- * |            |            band width             |
- * |            |        16       |        32       |
- * +------------+-----------------+-----------------+
- * |            | single register | 2 regs parallel |
- * |          8 |   sse_b8_r1.h   |   sse_b8_r2.h   |
- * | bit        |   diag / diff   |   diag / diff   |
- * | width      +-----------------+-----------------+
- * |            | 2 regs parallel | 4 regs parallel |
- * |         16 |  sse_b16_r2.h   |  sse_b16_r4.h   |
- * |            |   diag / diff   |   diag / diff   |
- * +------------+-----------------+-----------------+
+ * +--------------------------------------------------------------------------------------------------------+
+ * |            |                                      band width                                           |
+ * |            |        16       |        32       |        64       |       128        |       256        |
+ * +------------+-----------------+-----------------+-----------------+------------------+------------------+
+ * |            | single register | 2 regs parallel | 4 regs parallel |                  |                  |
+ * |          8 |   sse_b8_r1.h   |   sse_b8_r2.h   |   sse_b8_r4.h   |   unsupported    |   unsupported    |
+ * |            |   diag / diff   |   diag / diff   |   diag / diff   |                  |                  |
+ * | bit        +-----------------+-----------------+-----------------+------------------+------------------+
+ * | width      | 2 regs parallel | 4 regs parallel | 8 regs parallel | 16 regs parallel | 32 regs parallel |
+ * |         16 |  sse_b16_r2.h   |  sse_b16_r4.h   |  sse_b16_r8.h   |  sse_b16_r16.h   |  sse_b16_r32.h   |
+ * |            |   diag / diff   |   diag / diff   |   diag / diff   |   diag (wide)    |   diag (wide)    |
+ * |            +-----------------+-----------------+-----------------+------------------+------------------+
+ * |            | 4 regs parallel | 8 regs parallel |                 |                  |                  |
+ * |         32 |  sse_b32_r4.h   |  sse_b32_r8.h   |   unsupported   |   unsupported    |   unsupported    |
+ * |            |   diag / diff   |   diag / diff   |                 |                  |                  |
+ * +------------+-----------------+-----------------+-----------------+------------------+------------------+
+ *
+ * The 128- and 256-cell wide variants no longer fit in the sixteen xmm
+ * registers; the compiler spills a part of the band to the stack.
  *
  * Complier flags:
  * To use macros in this header, the SIMD_BAND_WIDTH and the SIMD_BIT_WIDTH
@@ -54,7 +61,7 @@
  	#elif SIMD_BIT_WIDTH == 32
  		#include "sse_b32_r4.h"
 	#else
- 		#error "The SIMD_BIT_WIDTH must be 8 or 16 in the 16-cell wide SSE4 variants."
+ 		#error "The SIMD_BIT_WIDTH must be 8, 16, or 32 in the 16-cell wide SSE4 variants."
  	#endif
 #elif SIMD_BAND_WIDTH == 32
 	#if SIMD_BIT_WIDTH == 8
@@ -64,7 +71,7 @@
  	#elif SIMD_BIT_WIDTH == 32
  		#include "sse_b32_r8.h"
 	#else
- 		#error "The SIMD_BIT_WIDTH must be 8 or 16 in the 32-cell wide SSE4 variants."
+ 		#error "The SIMD_BIT_WIDTH must be 8, 16, or 32 in the 32-cell wide SSE4 variants."
  	#endif
 #elif SIMD_BAND_WIDTH == 64
 	#if SIMD_BIT_WIDTH == 8
@@ -74,8 +81,20 @@
 	#else
  		#error "The SIMD_BIT_WIDTH must be 8 or 16 in the 64-cell wide SSE4 variants."
  	#endif
+#elif SIMD_BAND_WIDTH == 128
+	#if SIMD_BIT_WIDTH == 16
+		#include "sse_b16_r16.h"
+	#else
+ 		#error "The SIMD_BIT_WIDTH must be 16 in the 128-cell wide SSE4 variants."
+ 	#endif
+#elif SIMD_BAND_WIDTH == 256
+	#if SIMD_BIT_WIDTH == 16
+		#include "sse_b16_r32.h"
+	#else
+ 		#error "The SIMD_BIT_WIDTH must be 16 in the 256-cell wide SSE4 variants."
+ 	#endif
 #else
- 	#error "The SIMD_BAND_WIDTH must be 16, 32, or 64 in the SSE4 variants."
+ 	#error "The SIMD_BAND_WIDTH must be 16, 32, 64, 128, or 256 in the SSE4 variants."
 #endif
 
 
@@ -0,0 +1,498 @@
+
+/**
+ * @file sse_b16_r16.h
+ *
+ * @brief a header for macros of packed 16-bit SSE4 instructions.
+ *
+ * @detail
+ * This is a collection of wrapper macros of SSE4.1 SIMD intrinsics.
+ * Each macro corresponds to a set of several intrinsics defined in
+ * smmintrin.h. The details of the intrinsics are found in the intel's
+ * website: https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+ * The required set of macros are documented in porting section of 
+ * README.md in the top directory of the library.
+ *
+ * 128 cells of 16-bit signed integers are held in 16 xmm registers.
+ *
+ * @sa sse.h
+ */
+#ifndef _SSE_B16_R16_H_INCLUDED
+#define _SSE_B16_R16_H_INCLUDED
+
+#include <smmintrin.h>
+
+/**
+ * register declarations. 
+ */
+#define DECLARE_VEC_CELL(v)			__m128i v##1, v##2, v##3, v##4, v##5, v##6, v##7, v##8, v##9, v##10, v##11, v##12, v##13, v##14, v##15, v##16
+#define DECLARE_VEC_CELL_REG(v)		__m128i register v##1, v##2, v##3, v##4, v##5, v##6, v##7, v##8, v##9, v##10, v##11, v##12, v##13, v##14, v##15, v##16
+#define DECLARE_VEC_CHAR_REG(v)		__m128i register v##1, v##2, v##3, v##4, v##5, v##6, v##7, v##8
+
+/**
+ * substitution to cell vectors
+ */
+#define VEC_ASSIGN(a, b) { \
+	(a##1) = (b##1); (a##2) = (b##2); \
+	(a##3) = (b##3); (a##4) = (b##4); \
+	(a##5) = (b##5); (a##6) = (b##6); \
+	(a##7) = (b##7); (a##8) = (b##8); \
+	(a##9) = (b##9); (a##10) = (b##10); \
+	(a##11) = (b##11); (a##12) = (b##12); \
+	(a##13) = (b##13); (a##14) = (b##14); \
+	(a##15) = (b##15); (a##16) = (b##16); \
+}
+
+#define VEC_SET(v, i) { \
+	(v##1) = _mm_set1_epi16(i); \
+	(v##2) = _mm_set1_epi16(i); \
+	(v##3) = _mm_set1_epi16(i); \
+	(v##4) = _mm_set1_epi16(i); \
+	(v##5) = _mm_set1_epi16(i); \
+	(v##6) = _mm_set1_epi16(i); \
+	(v##7) = _mm_set1_epi16(i); \
+	(v##8) = _mm_set1_epi16(i); \
+	(v##9) = _mm_set1_epi16(i); \
+	(v##10) = _mm_set1_epi16(i); \
+	(v##11) = _mm_set1_epi16(i); \
+	(v##12) = _mm_set1_epi16(i); \
+	(v##13) = _mm_set1_epi16(i); \
+	(v##14) = _mm_set1_epi16(i); \
+	(v##15) = _mm_set1_epi16(i); \
+	(v##16) = _mm_set1_epi16(i); \
+}
+
+#define VEC_SETZERO(v) { \
+	(v##1) = _mm_setzero_si128(); \
+	(v##2) = _mm_setzero_si128(); \
+	(v##3) = _mm_setzero_si128(); \
+	(v##4) = _mm_setzero_si128(); \
+	(v##5) = _mm_setzero_si128(); \
+	(v##6) = _mm_setzero_si128(); \
+	(v##7) = _mm_setzero_si128(); \
+	(v##8) = _mm_setzero_si128(); \
+	(v##9) = _mm_setzero_si128(); \
+	(v##10) = _mm_setzero_si128(); \
+	(v##11) = _mm_setzero_si128(); \
+	(v##12) = _mm_setzero_si128(); \
+	(v##13) = _mm_setzero_si128(); \
+	(v##14) = _mm_setzero_si128(); \
+	(v##15) = _mm_setzero_si128(); \
+	(v##16) = _mm_setzero_si128(); \
+}
+
+#define VEC_SETONES(v) { \
+	(v##1) = _mm_set1_epi8(0xff); \
+	(v##2) = _mm_set1_epi8(0xff); \
+	(v##3) = _mm_set1_epi8(0xff); \
+	(v##4) = _mm_set1_epi8(0xff); \
+	(v##5) = _mm_set1_epi8(0xff); \
+	(v##6) = _mm_set1_epi8(0xff); \
+	(v##7) = _mm_set1_epi8(0xff); \
+	(v##8) = _mm_set1_epi8(0xff); \
+	(v##9) = _mm_set1_epi8(0xff); \
+	(v##10) = _mm_set1_epi8(0xff); \
+	(v##11) = _mm_set1_epi8(0xff); \
+	(v##12) = _mm_set1_epi8(0xff); \
+	(v##13) = _mm_set1_epi8(0xff); \
+	(v##14) = _mm_set1_epi8(0xff); \
+	(v##15) = _mm_set1_epi8(0xff); \
+	(v##16) = _mm_set1_epi8(0xff); \
+}
+
+/**
+ * substitution to char vectors
+ */
+#define VEC_CHAR_SETZERO(v) { \
+	(v##1) = _mm_setzero_si128(); \
+	(v##2) = _mm_setzero_si128(); \
+	(v##3) = _mm_setzero_si128(); \
+	(v##4) = _mm_setzero_si128(); \
+	(v##5) = _mm_setzero_si128(); \
+	(v##6) = _mm_setzero_si128(); \
+	(v##7) = _mm_setzero_si128(); \
+	(v##8) = _mm_setzero_si128(); \
+}
+
+#define VEC_CHAR_SETONES(v) { \
+	(v##1) = _mm_set1_epi8(0xff); \
+	(v##2) = _mm_set1_epi8(0xff); \
+	(v##3) = _mm_set1_epi8(0xff); \
+	(v##4) = _mm_set1_epi8(0xff); \
+	(v##5) = _mm_set1_epi8(0xff); \
+	(v##6) = _mm_set1_epi8(0xff); \
+	(v##7) = _mm_set1_epi8(0xff); \
+	(v##8) = _mm_set1_epi8(0xff); \
+}
+
+/**
+ * special substitution macros
+ */
+#define VEC_SET_LHALF(v, i) { \
+	(v##1) = _mm_set1_epi16(i); \
+	(v##2) = _mm_set1_epi16(i); \
+	(v##3) = _mm_set1_epi16(i); \
+	(v##4) = _mm_set1_epi16(i); \
+	(v##5) = _mm_set1_epi16(i); \
+	(v##6) = _mm_set1_epi16(i); \
+	(v##7) = _mm_set1_epi16(i); \
+	(v##8) = _mm_set1_epi16(i); \
+	(v##9) = _mm_setzero_si128(); \
+	(v##10) = _mm_setzero_si128(); \
+	(v##11) = _mm_setzero_si128(); \
+	(v##12) = _mm_setzero_si128(); \
+	(v##13) = _mm_setzero_si128(); \
+	(v##14) = _mm_setzero_si128(); \
+	(v##15) = _mm_setzero_si128(); \
+	(v##16) = _mm_setzero_si128(); \
+}
+
+#define VEC_SET_UHALF(v, i) { \
+	(v##1) = _mm_setzero_si128(); \
+	(v##2) = _mm_setzero_si128(); \
+	(v##3) = _mm_setzero_si128(); \
+	(v##4) = _mm_setzero_si128(); \
+	(v##5) = _mm_setzero_si128(); \
+	(v##6) = _mm_setzero_si128(); \
+	(v##7) = _mm_setzero_si128(); \
+	(v##8) = _mm_setzero_si128(); \
+	(v##9) = _mm_set1_epi16(i); \
+	(v##10) = _mm_set1_epi16(i); \
+	(v##11) = _mm_set1_epi16(i); \
+	(v##12) = _mm_set1_epi16(i); \
+	(v##13) = _mm_set1_epi16(i); \
+	(v##14) = _mm_set1_epi16(i); \
+	(v##15) = _mm_set1_epi16(i); \
+	(v##16) = _mm_set1_epi16(i); \
+}
+
+#define VEC_SETF_MSB(v) { \
+	VEC_SETZERO(v); VEC_INSERT_MSB((v), 0xf0); \
+}
+
+#define VEC_SETF_LSB(v) { \
+	VEC_SETZERO(v); VEC_INSERT_LSB((v), 0x0f); \
+}
+
+/**
+ * insertion and extraction macros
+ */
+#define VEC_INSERT_MSB(v, a) { \
+	(v##16) = _mm_insert_epi16((v##16), (a), 7); \
+}
+
+#define VEC_INSERT_LSB(v, a) { \
+	(v##1) = _mm_insert_epi16((v##1), (a), 0); \
+}
+
+#define VEC_MSB(v)		( (signed short)_mm_extract_epi16((v##16), 7) )
+#define VEC_LSB(v)		( (signed short)_mm_extract_epi16((v##1), 0) )
+#define VEC_CENTER(v)	( (signed short)_mm_extract_epi16((v##9), 0) )
+
+/**
+ * arithmetic and logic operations
+ */
+#define VEC_OR(a, b, c) { \
+	(a##1) = _mm_or_si128((b##1), (c##1)); \
+	(a##2) = _mm_or_si128((b##2), (c##2)); \
+	(a##3) = _mm_or_si128((b##3), (c##3)); \
+	(a##4) = _mm_or_si128((b##4), (c##4)); \
+	(a##5) = _mm_or_si128((b##5), (c##5)); \
+	(a##6) = _mm_or_si128((b##6), (c##6)); \
+	(a##7) = _mm_or_si128((b##7), (c##7)); \
+	(a##8) = _mm_or_si128((b##8), (c##8)); \
+	(a##9) = _mm_or_si128((b##9), (c##9)); \
+	(a##10) = _mm_or_si128((b##10), (c##10)); \
+	(a##11) = _mm_or_si128((b##11), (c##11)); \
+	(a##12) = _mm_or_si128((b##12), (c##12)); \
+	(a##13) = _mm_or_si128((b##13), (c##13)); \
+	(a##14) = _mm_or_si128((b##14), (c##14)); \
+	(a##15) = _mm_or_si128((b##15), (c##15)); \
+	(a##16) = _mm_or_si128((b##16), (c##16)); \
+}
+
+#define VEC_ADD(a, b, c) { \
+	(a##1) = _mm_adds_epi16((b##1), (c##1)); \
+	(a##2) = _mm_adds_epi16((b##2), (c##2)); \
+	(a##3) = _mm_adds_epi16((b##3), (c##3)); \
+	(a##4) = _mm_adds_epi16((b##4), (c##4)); \
+	(a##5) = _mm_adds_epi16((b##5), (c##5)); \
+	(a##6) = _mm_adds_epi16((b##6), (c##6)); \
+	(a##7) = _mm_adds_epi16((b##7), (c##7)); \
+	(a##8) = _mm_adds_epi16((b##8), (c##8)); \
+	(a##9) = _mm_adds_epi16((b##9), (c##9)); \
+	(a##10) = _mm_adds_epi16((b##10), (c##10)); \
+	(a##11) = _mm_adds_epi16((b##11), (c##11)); \
+	(a##12) = _mm_adds_epi16((b##12), (c##12)); \
+	(a##13) = _mm_adds_epi16((b##13), (c##13)); \
+	(a##14) = _mm_adds_epi16((b##14), (c##14)); \
+	(a##15) = _mm_adds_epi16((b##15), (c##15)); \
+	(a##16) = _mm_adds_epi16((b##16), (c##16)); \
+}
+
+#define VEC_ADDS(a, b, c) { \
+	(a##1) = _mm_adds_epu16((b##1), (c##1)); \
+	(a##2) = _mm_adds_epu16((b##2), (c##2)); \
+	(a##3) = _mm_adds_epu16((b##3), (c##3)); \
+	(a##4) = _mm_adds_epu16((b##4), (c##4)); \
+	(a##5) = _mm_adds_epu16((b##5), (c##5)); \
+	(a##6) = _mm_adds_epu16((b##6), (c##6)); \
+	(a##7) = _mm_adds_epu16((b##7), (c##7)); \
+	(a##8) = _mm_adds_epu16((b##8), (c##8)); \
+	(a##9) = _mm_adds_epu16((b##9), (c##9)); \
+	(a##10) = _mm_adds_epu16((b##10), (c##10)); \
+	(a##11) = _mm_adds_epu16((b##11), (c##11)); \
+	(a##12) = _mm_adds_epu16((b##12), (c##12)); \
+	(a##13) = _mm_adds_epu16((b##13), (c##13)); \
+	(a##14) = _mm_adds_epu16((b##14), (c##14)); \
+	(a##15) = _mm_adds_epu16((b##15), (c##15)); \
+	(a##16) = _mm_adds_epu16((b##16), (c##16)); \
+}
+
+#define VEC_SUB(a, b, c) { \
+	(a##1) = _mm_subs_epi16((b##1), (c##1)); \
+	(a##2) = _mm_subs_epi16((b##2), (c##2)); \
+	(a##3) = _mm_subs_epi16((b##3), (c##3)); \
+	(a##4) = _mm_subs_epi16((b##4), (c##4)); \
+	(a##5) = _mm_subs_epi16((b##5), (c##5)); \
+	(a##6) = _mm_subs_epi16((b##6), (c##6)); \
+	(a##7) = _mm_subs_epi16((b##7), (c##7)); \
+	(a##8) = _mm_subs_epi16((b##8), (c##8)); \
+	(a##9) = _mm_subs_epi16((b##9), (c##9)); \
+	(a##10) = _mm_subs_epi16((b##10), (c##10)); \
+	(a##11) = _mm_subs_epi16((b##11), (c##11)); \
+	(a##12) = _mm_subs_epi16((b##12), (c##12)); \
+	(a##13) = _mm_subs_epi16((b##13), (c##13)); \
+	(a##14) = _mm_subs_epi16((b##14), (c##14)); \
+	(a##15) = _mm_subs_epi16((b##15), (c##15)); \
+	(a##16) = _mm_subs_epi16((b##16), (c##16)); \
+}
+
+#define VEC_SUBS(a, b, c) { \
+	(a##1) = _mm_subs_epu16((b##1), (c##1)); \
+	(a##2) = _mm_subs_epu16((b##2), (c##2)); \
+	(a##3) = _mm_subs_epu16((b##3), (c##3)); \
+	(a##4) = _mm_subs_epu16((b##4), (c##4)); \
+	(a##5) = _mm_subs_epu16((b##5), (c##5)); \
+	(a##6) = _mm_subs_epu16((b##6), (c##6)); \
+	(a##7) = _mm_subs_epu16((b##7), (c##7)); \
+	(a##8) = _mm_subs_epu16((b##8), (c##8)); \
+	(a##9) = _mm_subs_epu16((b##9), (c##9)); \
+	(a##10) = _mm_subs_epu16((b##10), (c##10)); \
+	(a##11) = _mm_subs_epu16((b##11), (c##11)); \
+	(a##12) = _mm_subs_epu16((b##12), (c##12)); \
+	(a##13) = _mm_subs_epu16((b##13), (c##13)); \
+	(a##14) = _mm_subs_epu16((b##14), (c##14)); \
+	(a##15) = _mm_subs_epu16((b##15), (c##15)); \
+	(a##16) = _mm_subs_epu16((b##16), (c##16)); \
+}
+
+#define VEC_MAX(a, b, c) { \
+	(a##1) = _mm_max_epi16((b##1), (c##1)); \
+	(a##2) = _mm_max_epi16((b##2), (c##2)); \
+	(a##3) = _mm_max_epi16((b##3), (c##3)); \
+	(a##4) = _mm_max_epi16((b##4), (c##4)); \
+	(a##5) = _mm_max_epi16((b##5), (c##5)); \
+	(a##6) = _mm_max_epi16((b##6), (c##6)); \
+	(a##7) = _mm_max_epi16((b##7), (c##7)); \
+	(a##8) = _mm_max_epi16((b##8), (c##8)); \
+	(a##9) = _mm_max_epi16((b##9), (c##9)); \
+	(a##10) = _mm_max_epi16((b##10), (c##10)); \
+	(a##11) = _mm_max_epi16((b##11), (c##11)); \
+	(a##12) = _mm_max_epi16((b##12), (c##12)); \
+	(a##13) = _mm_max_epi16((b##13), (c##13)); \
+	(a##14) = _mm_max_epi16((b##14), (c##14)); \
+	(a##15) = _mm_max_epi16((b##15), (c##15)); \
+	(a##16) = _mm_max_epi16((b##16), (c##16)); \
+}
+
+#define VEC_MIN(a, b, c) { \
+	(a##1) = _mm_min_epi16((b##1), (c##1)); \
+	(a##2) = _mm_min_epi16((b##2), (c##2)); \
+	(a##3) = _mm_min_epi16((b##3), (c##3)); \
+	(a##4) = _mm_min_epi16((b##4), (c##4)); \
+	(a##5) = _mm_min_epi16((b##5), (c##5)); \
+	(a##6) = _mm_min_epi16((b##6), (c##6)); \
+	(a##7) = _mm_min_epi16((b##7), (c##7)); \
+	(a##8) = _mm_min_epi16((b##8), (c##8)); \
+	(a##9) = _mm_min_epi16((b##9), (c##9)); \
+	(a##10) = _mm_min_epi16((b##10), (c##10)); \
+	(a##11) = _mm_min_epi16((b##11), (c##11)); \
+	(a##12) = _mm_min_epi16((b##12), (c##12)); \
+	(a##13) = _mm_min_epi16((b##13), (c##13)); \
+	(a##14) = _mm_min_epi16((b##14), (c##14)); \
+	(a##15) = _mm_min_epi16((b##15), (c##15)); \
+	(a##16) = _mm_min_epi16((b##16), (c##16)); \
+}
+
+#define VEC_HMAX(a, b) { \
+	(b##1) = _mm_max_epi16((b##1), (b##9)); \
+	(b##2) = _mm_max_epi16((b##2), (b##10)); \
+	(b##3) = _mm_max_epi16((b##3), (b##11)); \
+	(b##4) = _mm_max_epi16((b##4), (b##12)); \
+	(b##5) = _mm_max_epi16((b##5), (b##13)); \
+	(b##6) = _mm_max_epi16((b##6), (b##14)); \
+	(b##7) = _mm_max_epi16((b##7), (b##15)); \
+	(b##8) = _mm_max_epi16((b##8), (b##16)); \
+	(b##1) = _mm_max_epi16((b##1), (b##5)); \
+	(b##2) = _mm_max_epi16((b##2), (b##6)); \
+	(b##3) = _mm_max_epi16((b##3), (b##7)); \
+	(b##4) = _mm_max_epi16((b##4), (b##8)); \
+	(b##1) = _mm_max_epi16((b##1), (b##3)); \
+	(b##2) = _mm_max_epi16((b##2), (b##4)); \
+	(b##1) = _mm_max_epi16((b##1), (b##2)); \
+	__m128i tmp = (b##1); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 8)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 4)); \
+	tmp = _mm_max_epi16(tmp, _mm_srli_si128(tmp, 2)); \
+	(a) = (signed short)_mm_extract_epi16(tmp, 0); \
+}
+
+/**
+ * shift operations
+ */
+#define VEC_SHIFT_R(a) { \
+	(a##1) = _mm_alignr_epi8((a##2), (a##1), 2); \
+	(a##2) = _mm_alignr_epi8((a##3), (a##2), 2); \
+	(a##3) = _mm_alignr_epi8((a##4), (a##3), 2); \
+	(a##4) = _mm_alignr_epi8((a##5), (a##4), 2); \
+	(a##5) = _mm_alignr_epi8((a##6), (a##5), 2); \
+	(a##6) = _mm_alignr_epi8((a##7), (a##6), 2); \
+	(a##7) = _mm_alignr_epi8((a##8), (a##7), 2); \
+	(a##8) = _mm_alignr_epi8((a##9), (a##8), 2); \
+	(a##9) = _mm_alignr_epi8((a##10), (a##9), 2); \
+	(a##10) = _mm_alignr_epi8((a##11), (a##10), 2); \
+	(a##11) = _mm_alignr_epi8((a##12), (a##11), 2); \
+	(a##12) = _mm_alignr_epi8((a##13), (a##12), 2); \
+	(a##13) = _mm_alignr_epi8((a##14), (a##13), 2); \
+	(a##14) = _mm_alignr_epi8((a##15), (a##14), 2); \
+	(a##15) = _mm_alignr_epi8((a##16), (a##15), 2); \
+	(a##16) = _mm_srli_si128((a##16), 2); \
+}
+
+#define VEC_SHIFT_L(a) { \
+	(a##16) = _mm_alignr_epi8((a##16), (a##15), 14); \
+	(a##15) = _mm_alignr_epi8((a##15), (a##14), 14); \
+	(a##14) = _mm_alignr_epi8((a##14), (a##13), 14); \
+	(a##13) = _mm_alignr_epi8((a##13), (a##12), 14); \
+	(a##12) = _mm_alignr_epi8((a##12), (a##11), 14); \
+	(a##11) = _mm_alignr_epi8((a##11), (a##10), 14); \
+	(a##10) = _mm_alignr_epi8((a##10), (a##9), 14); \
+	(a##9) = _mm_alignr_epi8((a##9), (a##8), 14); \
+	(a##8) = _mm_alignr_epi8((a##8), (a##7), 14); \
+	(a##7) = _mm_alignr_epi8((a##7), (a##6), 14); \
+	(a##6) = _mm_alignr_epi8((a##6), (a##5), 14); \
+	(a##5) = _mm_alignr_epi8((a##5), (a##4), 14); \
+	(a##4) = _mm_alignr_epi8((a##4), (a##3), 14); \
+	(a##3) = _mm_alignr_epi8((a##3), (a##2), 14); \
+	(a##2) = _mm_alignr_epi8((a##2), (a##1), 14); \
+	(a##1) = _mm_slli_si128((a##1), 2); \
+}
+
+/**
+ * compare and select
+ */
+#define VEC_COMPARE(a, b, c) { \
+	__m128i mask1 = _mm_cmpeq_epi8((b##1), (c##1)); \
+	__m128i mask2 = _mm_cmpeq_epi8((b##2), (c##2)); \
+	__m128i mask3 = _mm_cmpeq_epi8((b##3), (c##3)); \
+	__m128i mask4 = _mm_cmpeq_epi8((b##4), (c##4)); \
+	__m128i mask5 = _mm_cmpeq_epi8((b##5), (c##5)); \
+	__m128i mask6 = _mm_cmpeq_epi8((b##6), (c##6)); \
+	__m128i mask7 = _mm_cmpeq_epi8((b##7), (c##7)); \
+	__m128i mask8 = _mm_cmpeq_epi8((b##8), (c##8)); \
+	(a##1) = _mm_cvtepi8_epi16(mask1); \
+	(a##2) = _mm_cvtepi8_epi16(_mm_srli_si128(mask1, 8)); \
+	(a##3) = _mm_cvtepi8_epi16(mask2); \
+	(a##4) = _mm_cvtepi8_epi16(_mm_srli_si128(mask2, 8)); \
+	(a##5) = _mm_cvtepi8_epi16(mask3); \
+	(a##6) = _mm_cvtepi8_epi16(_mm_srli_si128(mask3, 8)); \
+	(a##7) = _mm_cvtepi8_epi16(mask4); \
+	(a##8) = _mm_cvtepi8_epi16(_mm_srli_si128(mask4, 8)); \
+	(a##9) = _mm_cvtepi8_epi16(mask5); \
+	(a##10) = _mm_cvtepi8_epi16(_mm_srli_si128(mask5, 8)); \
+	(a##11) = _mm_cvtepi8_epi16(mask6); \
+	(a##12) = _mm_cvtepi8_epi16(_mm_srli_si128(mask6, 8)); \
+	(a##13) = _mm_cvtepi8_epi16(mask7); \
+	(a##14) = _mm_cvtepi8_epi16(_mm_srli_si128(mask7, 8)); \
+	(a##15) = _mm_cvtepi8_epi16(mask8); \
+	(a##16) = _mm_cvtepi8_epi16(_mm_srli_si128(mask8, 8)); \
+}
+
+#define VEC_SELECT(a, b, c, d) { \
+	(a##1) = _mm_blendv_epi8((b##1), (c##1), (d##1)); \
+	(a##2) = _mm_blendv_epi8((b##2), (c##2), (d##2)); \
+	(a##3) = _mm_blendv_epi8((b##3), (c##3), (d##3)); \
+	(a##4) = _mm_blendv_epi8((b##4), (c##4), (d##4)); \
+	(a##5) = _mm_blendv_epi8((b##5), (c##5), (d##5)); \
+	(a##6) = _mm_blendv_epi8((b##6), (c##6), (d##6)); \
+	(a##7) = _mm_blendv_epi8((b##7), (c##7), (d##7)); \
+	(a##8) = _mm_blendv_epi8((b##8), (c##8), (d##8)); \
+	(a##9) = _mm_blendv_epi8((b##9), (c##9), (d##9)); \
+	(a##10) = _mm_blendv_epi8((b##10), (c##10), (d##10)); \
+	(a##11) = _mm_blendv_epi8((b##11), (c##11), (d##11)); \
+	(a##12) = _mm_blendv_epi8((b##12), (c##12), (d##12)); \
+	(a##13) = _mm_blendv_epi8((b##13), (c##13), (d##13)); \
+	(a##14) = _mm_blendv_epi8((b##14), (c##14), (d##14)); \
+	(a##15) = _mm_blendv_epi8((b##15), (c##15), (d##15)); \
+	(a##16) = _mm_blendv_epi8((b##16), (c##16), (d##16)); \
+}
+
+/**
+ * load and store operations
+ */
+#define VEC_STORE(p, v) { \
+	_mm_store_si128((__m128i *)(p), v##1); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##2); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##3); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##4); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##5); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##6); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##7); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##8); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##9); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##10); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##11); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##12); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##13); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##14); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##15); p += sizeof(__m128i); \
+	_mm_store_si128((__m128i *)(p), v##16); p += sizeof(__m128i); \
+}
+
+/**
+ * char vector operations
+ */
+#define VEC_CHAR_SHIFT_R(a) { \
+	(a##1) = _mm_alignr_epi8((a##2), (a##1), 1); \
+	(a##2) = _mm_alignr_epi8((a##3), (a##2), 1); \
+	(a##3) = _mm_alignr_epi8((a##4), (a##3), 1); \
+	(a##4) = _mm_alignr_epi8((a##5), (a##4), 1); \
+	(a##5) = _mm_alignr_epi8((a##6), (a##5), 1); \
+	(a##6) = _mm_alignr_epi8((a##7), (a##6), 1); \
+	(a##7) = _mm_alignr_epi8((a##8), (a##7), 1); \
+	(a##8) = _mm_srli_si128((a##8), 1); \
+}
+
+#define VEC_CHAR_SHIFT_L(a) { \
+	(a##8) = _mm_alignr_epi8((a##8), (a##7), 15); \
+	(a##7) = _mm_alignr_epi8((a##7), (a##6), 15); \
+	(a##6) = _mm_alignr_epi8((a##6), (a##5), 15); \
+	(a##5) = _mm_alignr_epi8((a##5), (a##4), 15); \
+	(a##4) = _mm_alignr_epi8((a##4), (a##3), 15); \
+	(a##3) = _mm_alignr_epi8((a##3), (a##2), 15); \
+	(a##2) = _mm_alignr_epi8((a##2), (a##1), 15); \
+	(a##1) = _mm_slli_si128((a##1), 1); \
+}
+
+#define VEC_CHAR_INSERT_MSB(x, y) { \
+	(x##8) = _mm_insert_epi8((x##8), (y), 15); \
+}
+
+#define VEC_CHAR_INSERT_LSB(x, y) { \
+	(x##1) = _mm_insert_epi8((x##1), (y), 0); \
+}
+
+#endif /* #ifndef _SSE_B16_R16_H_INCLUDED */
+/**
+ * end of sse_b16_r16.h
+ */